@@ -0,0 +1,199 @@
+#!/bin/sh
+# forksort benchmark by Stefan Geyer
+#
+# Usage: bench.sh forksort measure outdir
+#
+# Generates random, sorted, reverse sorted and duplicate heavy inputs, runs forksort in every mode and
+# writes wall time, processes, threads, syscalls, peak RSS and lines/s to outdir/results.csv.
+# Afterwards the scaling against the amount of cores is written to outdir/scaling.csv and plotted.
+#
+# Environment (defaults in brackets):
+#   BENCH_SIZES       line amounts [1000 10000 100000 1000000 10000000]
+#   BENCH_DATASETS    inputs [random sorted reverse duplicates]
+#   BENCH_MODES       forksort options per run, ',' separates options of one run [default -b -z -a -u -a,-z -l,100]
+#   BENCH_MAX_PROCS   process budget of every run, passed as --max-procs [131072]
+#   BENCH_TIMEOUT     seconds per run, needs timeout(1) [300]
+#   BENCH_TRACE       1 to count processes, threads and syscalls in a second, traced run [1]
+#   BENCH_DISTINCT    distinct lines of the duplicate heavy input [100]
+#   BENCH_SCALING     dataset:lines:mode of the scaling runs [random:10000:default]
+#   BENCH_CORES       core counts of the scaling runs [1 2 4 ... online cores]
+
+FORKSORT=$1
+MEASURE=$2
+OUT=$3
+
+if [ -z "$FORKSORT" ] || [ -z "$MEASURE" ] || [ -z "$OUT" ]; then
+    echo "Usage: $0 forksort measure outdir" >&2
+    exit 1
+fi
+
+SIZES=${BENCH_SIZES:-"1000 10000 100000 1000000 10000000"}
+DATASETS=${BENCH_DATASETS:-"random sorted reverse duplicates"}
+MODES=${BENCH_MODES:-"default -b -z -a -u -a,-z -l,100"}
+MAX_PROCS=${BENCH_MAX_PROCS:-131072}
+TIMEOUT=${BENCH_TIMEOUT:-300}
+TRACE=${BENCH_TRACE:-1}
+DISTINCT=${BENCH_DISTINCT:-100}
+SCALING=${BENCH_SCALING:-"random:10000:default"}
+CPUS=$(getconf _NPROCESSORS_ONLN)
+
+if [ -z "$BENCH_CORES" ]; then
+    BENCH_CORES=""
+    cores=1
+    while [ "$cores" -lt "$CPUS" ]; do
+        BENCH_CORES="$BENCH_CORES $cores"
+        cores=$((cores * 2))
+    done
+    BENCH_CORES="$BENCH_CORES $CPUS"
+fi
+
+mkdir -p "$OUT/data" || exit 1
+
+# Writes n lines of 16 random hex digits, or of one of $DISTINCT values
+generate() {
+    awk -v n="$1" -v seed="$1" -v distinct="$2" 'BEGIN {
+        srand(seed)
+        for (i = 0; i < n; i++) {
+            if (distinct > 0) {
+                printf "%08d\n", int(rand() * distinct)
+            } else {
+                printf "%04x%04x%04x%04x\n", int(rand() * 65536), int(rand() * 65536),
+                       int(rand() * 65536), int(rand() * 65536)
+            }
+        }
+    }'
+}
+
+# Creates the input file of a dataset once and prints its path
+dataset() {
+    file="$OUT/data/$1-$2.txt"
+
+    if [ ! -f "$file" ]; then
+        {
+            echo "$2"
+            case $1 in
+                random) generate "$2" 0 ;;
+                sorted) generate "$2" 0 | LC_ALL=C sort ;;
+                reverse) generate "$2" 0 | LC_ALL=C sort -r ;;
+                duplicates) generate "$2" "$DISTINCT" ;;
+                *) echo "Unknown dataset $1" >&2; exit 1 ;;
+            esac
+        } > "$file.tmp" && mv "$file.tmp" "$file"
+    fi
+
+    echo "$file"
+}
+
+# Runs forksort once per measure mode, prints status,wall,maxrss,processes,threads,syscalls
+measure() {
+    file=$1
+    shift
+
+    limit=""
+    if command -v timeout > /dev/null 2>&1; then limit="timeout $TIMEOUT"; fi
+
+    # Only the statistics of measure are kept, forksort's own errors end up before them
+    stats=$($limit "$MEASURE" "$FORKSORT" "$@" < "$file" 2>&1 > /dev/null)
+    status=$?
+    stats=$(echo "$stats" | tail -n 1)
+    wall=$(echo "$stats" | cut -d, -f1)
+    maxrss=$(echo "$stats" | cut -d, -f2)
+    counts="-1,-1,-1"
+
+    if [ "$TRACE" = 1 ] && [ "$status" = 0 ]; then
+        traced=$($limit "$MEASURE" -t "$FORKSORT" "$@" < "$file" 2>&1 > /dev/null | tail -n 1)
+        case $traced in
+            [0-9]*) counts=$(echo "$traced" | cut -d, -f3-5) ;;
+        esac
+    fi
+
+    case $stats in
+        [0-9]*) ;;
+        *) status=fail; wall=""; maxrss="" ;;
+    esac
+
+    echo "$status,$wall,$maxrss,$counts"
+}
+
+# Splits a mode into forksort options
+options() {
+    if [ "$1" = default ]; then echo ""; else echo "$1" | tr ',' ' '; fi
+}
+
+RESULTS="$OUT/results.csv"
+echo "dataset,lines,mode,status,wall_s,lines_per_s,processes,threads,syscalls,maxrss_kb" > "$RESULTS"
+printf "%-10s %9s %-8s %-6s %10s %12s %9s %8s %10s %10s\n" \
+       dataset lines mode status wall_s lines/s procs threads syscalls rss_kb
+
+for size in $SIZES; do
+    for set in $DATASETS; do
+        file=$(dataset "$set" "$size") || exit 1
+
+        for mode in $MODES; do
+            # forksort stops forking at the budget and sorts the rest itself, so every size can run
+            # shellcheck disable=SC2046
+            row=$(measure "$file" --max-procs "$MAX_PROCS" $(options "$mode"))
+
+            IFS=, read -r status wall maxrss procs threads syscalls <<ROW
+$row
+ROW
+            rate=""
+            if [ "$status" = 0 ]; then
+                rate=$(awk -v n="$size" -v t="$wall" 'BEGIN { printf "%.0f", (t > 0 ? n / t : 0) }')
+            fi
+
+            # Options are separated by spaces in the results, so the CSV stays parseable
+            name=$(options "$mode")
+            if [ -z "$name" ]; then name=default; fi
+
+            echo "$set,$size,$name,$status,$wall,$rate,$procs,$threads,$syscalls,$maxrss" >> "$RESULTS"
+            printf "%-10s %9s %-8s %-6s %10s %12s %9s %8s %10s %10s\n" "$set" "$size" "$name" "$status" "$wall" \
+                   "$rate" "$procs" "$threads" "$syscalls" "$maxrss"
+        done
+    done
+done
+
+# Scaling runs pin forksort to the first cores and let merges use the same amount of threads
+set=$(echo "$SCALING" | cut -d: -f1)
+size=$(echo "$SCALING" | cut -d: -f2)
+mode=$(echo "$SCALING" | cut -d: -f3)
+file=$(dataset "$set" "$size") || exit 1
+
+SCALE="$OUT/scaling.csv"
+echo "cores,wall_s,speedup" > "$SCALE"
+echo
+echo "Scaling of $set with $size lines, mode $mode"
+
+if ! command -v taskset > /dev/null 2>&1; then
+    echo "taskset not found, skipping scaling runs" >&2
+    exit 0
+fi
+
+base=""
+for cores in $BENCH_CORES; do
+    # shellcheck disable=SC2046
+    stats=$(taskset -c "0-$((cores - 1))" "$MEASURE" "$FORKSORT" --max-procs "$MAX_PROCS" $(options "$mode") \
+            -j "$cores" < "$file" 2>&1 > /dev/null | tail -n 1)
+    wall=$(echo "$stats" | cut -d, -f1)
+    if [ -z "$base" ]; then base=$wall; fi
+
+    speedup=$(awk -v b="$base" -v t="$wall" 'BEGIN { printf "%.2f", (t > 0 ? b / t : 0) }')
+    echo "$cores,$wall,$speedup" >> "$SCALE"
+
+    # Text plot, one # per quarter of speedup
+    bar=$(awk -v s="$speedup" 'BEGIN { for (i = 0; i < s * 4; i++) printf "#" }')
+    printf "%4s cores %10ss %6sx %s\n" "$cores" "$wall" "$speedup" "$bar"
+done
+
+if command -v gnuplot > /dev/null 2>&1; then
+    gnuplot <<EOF
+set terminal png size 800,600
+set output "$OUT/scaling.png"
+set datafile separator ","
+set key top left
+set xlabel "cores"
+set ylabel "speedup"
+plot "$SCALE" using 1:3 skip 1 with linespoints title "forksort", x title "linear"
+EOF
+    echo "Plot written to $OUT/scaling.png"
+fi
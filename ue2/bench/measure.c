@@ -0,0 +1,245 @@
+/**
+ * @file measure.c
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Benchmark measurement helper.
+ *
+ * Runs a command and reports its wall time and the peak RSS of its process tree. With -t the whole tree
+ * is traced with ptrace instead, to count the created processes and threads and the executed syscalls.
+ **/
+
+#define _GNU_SOURCE /**< __WALL and the ptrace options are Linux extensions */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/ptrace.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/**
+ * @struct Result struct
+ * @brief Everything measured for one run
+ * @details Typedef as result_t
+ */
+typedef struct result {
+    double wall; /**< Wall time in seconds */
+    long int maxrss; /**< Largest resident set size of a single process in KiB */
+    long int processes; /**< Amount of processes, including the started one */
+    long int threads; /**< Amount of threads created in addition to the main threads */
+    long int syscalls; /**< Amount of syscall stops divided by two (entry and exit) */
+    int status; /**< Exit code of the command, 128 + signal if it was killed */
+} result_t;
+
+static char *pgm_name; /**< The program name */
+
+/**
+ * Mandatory usage function.
+ *
+ * @brief This function writes helpful usage information about the program to stderr.
+ * @details Global variables: pgm_name
+ */
+static void usage(void);
+
+/**
+ * Error exit
+ *
+ * @brief Prints message and errno to stderr and exits with EXIT_FAILURE
+ *
+ * @param message The message to print
+ */
+static void error_exit(char *message);
+
+/**
+ * Convert wait status
+ *
+ * @brief Converts a wait status to a shell like exit code
+ *
+ * @param status The wait status
+ * @return The exit code, 128 + signal if the process was killed
+ */
+static int exit_code(int status);
+
+/**
+ * Run untraced
+ *
+ * @brief Runs argv and measures wall time and peak RSS
+ * @details The peak RSS is only complete if every process waits for its children
+ *
+ * @param argv The command to run
+ * @param result The measurements will be stored here
+ */
+static void run(char *argv[], result_t *result);
+
+/**
+ * Run traced
+ *
+ * @brief Runs argv under ptrace and counts processes, threads and syscalls of the whole tree
+ *
+ * @param argv The command to run
+ * @param result The counts and the exit code will be stored here
+ */
+static void run_traced(char *argv[], result_t *result);
+
+/**
+ * Program entry point.
+ *
+ * @brief Parses the options, runs the command and prints the measurements as one CSV line to stderr
+ * @details The line contains wall time, peak RSS, processes, threads and syscalls. Counts are -1 without -t.
+ *
+ * @param argc The argument counter.
+ * @param argv The argument vector.
+ * @return The exit code of the command
+ */
+int main(int argc, char *argv[]) {
+    bool traced = false;
+    int c;
+
+    pgm_name = argv[0];
+
+    while ((c = getopt(argc, argv, "+t")) != -1) {
+        switch (c) {
+            case 't':
+                traced = true;
+                break;
+            default:
+                usage();
+        }
+    }
+
+    if (optind >= argc) usage();
+
+    result_t result = {.processes = -1, .threads = -1, .syscalls = -1};
+
+    if (traced) {
+        run_traced(&argv[optind], &result);
+    } else {
+        run(&argv[optind], &result);
+    }
+
+    fprintf(stderr, "%.6f,%ld,%ld,%ld,%ld\n", result.wall, result.maxrss, result.processes, result.threads,
+            result.syscalls);
+
+    return result.status;
+}
+
+static void usage(void) {
+    fprintf(stderr, "SYNOPSIS:\n\t%s [-t] command [argument...]\n", pgm_name);
+    fprintf(stderr, "\t-t\ttrace the process tree and count processes, threads and syscalls\n");
+    exit(EXIT_FAILURE);
+}
+
+static void error_exit(char *message) {
+    fprintf(stderr, "%s: %s", pgm_name, message);
+    if (errno != 0) fprintf(stderr, " (%s)", strerror(errno));
+    fprintf(stderr, "\n");
+    exit(EXIT_FAILURE);
+}
+
+static int exit_code(int status) {
+    if (WIFSIGNALED(status)) return 128 + WTERMSIG(status);
+    return WEXITSTATUS(status);
+}
+
+static void run(char *argv[], result_t *result) {
+    struct timespec start, end;
+    struct rusage usage;
+    int status;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pid_t pid = fork();
+    if (pid == -1) error_exit("Cannot fork");
+    if (pid == 0) {
+        execvp(argv[0], argv);
+        error_exit("Cannot execute command");
+    }
+
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR) error_exit("Cannot wait for command");
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (getrusage(RUSAGE_CHILDREN, &usage) == -1) error_exit("Cannot get resource usage");
+
+    result->wall = (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) / 1e9;
+    result->maxrss = usage.ru_maxrss;
+    result->status = exit_code(status);
+}
+
+static void run_traced(char *argv[], result_t *result) {
+    struct timespec start, end;
+    struct rusage usage;
+    long int stops = 0;
+    int status;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pid_t pid = fork();
+    if (pid == -1) error_exit("Cannot fork");
+    if (pid == 0) {
+        if (ptrace(PTRACE_TRACEME, 0, NULL, NULL) == -1) error_exit("Cannot trace command");
+        raise(SIGSTOP);
+        execvp(argv[0], argv);
+        error_exit("Cannot execute command");
+    }
+
+    if (waitpid(pid, &status, 0) == -1) error_exit("Cannot wait for command");
+
+    // New processes and threads are traced automatically, exec stops are reported as events
+    long opts = PTRACE_O_TRACESYSGOOD | PTRACE_O_TRACEFORK | PTRACE_O_TRACEVFORK | PTRACE_O_TRACECLONE |
+                PTRACE_O_TRACEEXEC | PTRACE_O_EXITKILL;
+    if (ptrace(PTRACE_SETOPTIONS, pid, NULL, (void *) opts) == -1) error_exit("Cannot set trace options");
+    if (ptrace(PTRACE_SYSCALL, pid, NULL, NULL) == -1) error_exit("Cannot resume command");
+
+    result->processes = 1;
+    result->threads = 0;
+
+    for (;;) {
+        pid_t tid = waitpid(-1, &status, __WALL);
+
+        if (tid == -1) {
+            if (errno == EINTR) continue;
+            if (errno == ECHILD) break;
+            error_exit("Cannot wait for command");
+        }
+
+        if (!WIFSTOPPED(status)) {
+            if (tid == pid) result->status = exit_code(status);
+            continue;
+        }
+
+        int signal = WSTOPSIG(status), event = status >> 16;
+
+        if (signal == (SIGTRAP | 0x80)) {
+            stops++;
+            signal = 0;
+        } else if (signal == SIGTRAP && event != 0) {
+            // fork and vfork report processes, clone without SIGCHLD reports threads
+            if (event == PTRACE_EVENT_FORK || event == PTRACE_EVENT_VFORK) result->processes++;
+            if (event == PTRACE_EVENT_CLONE) result->threads++;
+            signal = 0;
+        } else if (signal == SIGSTOP) {
+            // Initial stop of a new tracee
+            signal = 0;
+        }
+
+        // The tracee may have been killed in the meantime
+        ptrace(PTRACE_SYSCALL, tid, NULL, (void *) (long) signal);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (getrusage(RUSAGE_CHILDREN, &usage) == -1) error_exit("Cannot get resource usage");
+
+    result->wall = (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) / 1e9;
+    result->maxrss = usage.ru_maxrss;
+    result->syscalls = (stops + 1) / 2;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file frame.c
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Binary framing module.
+ *
+ * Implements reading and writing of length-prefixed frames, so that lines never have to be re-tokenized.
+ **/
+
+#include <stdlib.h>
+#include <memory.h>
+#include <unistd.h>
+#include <errno.h>
+#include "frame.h"
+#include "output.h"
+
+/**
+ * Read a fixed amount of bytes
+ *
+ * @brief Reads until size bytes have been read or EOF is reached
+ * @details Exits if a read fails
+ *
+ * @param fd The file descriptor to read from
+ * @param buffer The buffer to read to
+ * @param size The amount of bytes to read
+ * @return The amount of bytes actually read
+ */
+static size_t read_full(int fd, void *buffer, size_t size);
+
+void frame_write(int fd, const line_t *lines, long int amount) {
+    frame_header_t header = {.count = (uint64_t) amount, .bytes = 0};
+    frame_length_t lengths[BATCH_SIZE / 2];
+    struct iovec iov[BATCH_SIZE];
+    int count = 0;
+
+    for (long int i = 0; i < amount; i++) {
+        if (lines[i].len > UINT32_MAX) error_exit("Line is too long to be framed");
+        header.bytes += sizeof(frame_length_t) + lines[i].len;
+    }
+
+    iov[count].iov_base = &header;
+    iov[count].iov_len = sizeof header;
+    count++;
+
+    // Gather length prefixes and contents, so every batch of records takes a single writev
+    for (long int i = 0; i < amount; i++) {
+        if (count > BATCH_SIZE - 2) {
+            write_vectors(fd, iov, count);
+            count = 0;
+        }
+
+        lengths[count / 2] = (frame_length_t) lines[i].len;
+
+        iov[count].iov_base = &lengths[count / 2];
+        iov[count].iov_len = sizeof(frame_length_t);
+        count++;
+        iov[count].iov_base = lines[i].data;
+        iov[count].iov_len = lines[i].len;
+        count++;
+    }
+
+    write_vectors(fd, iov, count);
+}
+
+line_t *frame_read(int fd, long int *amount, char **buffer) {
+    frame_header_t header;
+
+    if (read_full(fd, &header, sizeof header) != sizeof header) error_exit("Cannot read frame header");
+
+    // Every record needs at least its length prefix
+    if (header.count > header.bytes / sizeof(frame_length_t) || header.bytes > SIZE_MAX - 1)
+        error_exit("Malformed frame header");
+
+    char *data = malloc((size_t) header.bytes + 1);
+    line_t *lines = malloc(sizeof(line_t) * ((size_t) header.count + 1));
+    if (data == NULL || lines == NULL) error_exit("Cannot allocate memory");
+
+    if (read_full(fd, data, (size_t) header.bytes) != header.bytes) error_exit("Cannot read frame records");
+
+    // Index records in place
+    size_t offset = 0;
+    for (uint64_t i = 0; i < header.count; i++) {
+        frame_length_t len;
+
+        if (header.bytes - offset < sizeof len) error_exit("Malformed frame record");
+        memcpy(&len, data + offset, sizeof len);
+        offset += sizeof len;
+
+        if (header.bytes - offset < len) error_exit("Malformed frame record");
+        lines[i].data = data + offset;
+        lines[i].len = len;
+        offset += len;
+    }
+
+    if (offset != header.bytes) error_exit("Malformed frame");
+
+    *amount = (long int) header.count;
+    *buffer = data;
+
+    return lines;
+}
+
+static size_t read_full(int fd, void *buffer, size_t size) {
+    size_t done = 0;
+
+    while (done < size) {
+        ssize_t r = read(fd, (char *) buffer + done, size - done);
+        if (r == -1) {
+            if (errno == EINTR) continue;
+            error_exit("Cannot read frame");
+        }
+        if (r == 0) break; // EOF
+        done += (size_t) r;
+    }
+
+    return done;
+}
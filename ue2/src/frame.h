@@ -0,0 +1,57 @@
+/**
+ * @file frame.h
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Binary framing header.
+ *
+ * A frame consists of a frame_header_t followed by count records. Each record is a frame_length_t
+ * holding the length of the line, directly followed by the line content without newline.
+ * Both sides of a pipe run on the same machine, so all numbers are in host byte order.
+ **/
+
+#ifndef UE2_FRAME_H
+#define UE2_FRAME_H
+
+#include <stdint.h>
+#include "main.h"
+
+/**
+ * @struct Frame header struct
+ * @brief Header that precedes every frame
+ * @details Typedef as frame_header_t
+ */
+typedef struct frame_header {
+    uint64_t count; /**< Amount of records in the frame */
+    uint64_t bytes; /**< Size of all records including their length prefixes */
+} frame_header_t;
+
+typedef uint32_t frame_length_t; /**< Length prefix of a single record */
+
+/**
+ * Write lines as frame
+ *
+ * @brief Writes a header and all lines as length-prefixed records to fd
+ * @details Exits if a write fails
+ *
+ * @param fd The file descriptor to write to
+ * @param lines The lines to write
+ * @param amount The amount of lines
+ */
+void frame_write(int fd, const line_t *lines, long int amount);
+
+/**
+ * Read lines from a frame
+ *
+ * @brief Reads a whole frame from fd with a single bulk read of the record section
+ * @details The returned lines point into *buffer. Both are malloced and need to be freed manually.
+ *          Exits if the frame is incomplete or malformed.
+ *
+ * @param fd The file descriptor to read from
+ * @param amount The amount of read lines will be stored here
+ * @param buffer The buffer holding the line contents will be stored here
+ * @return The read lines
+ */
+line_t *frame_read(int fd, long int *amount, char **buffer);
+
+#endif //UE2_FRAME_H
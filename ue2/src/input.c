@@ -0,0 +1,130 @@
+/**
+ * @file input.c
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Bulk input module.
+ *
+ * Reads inputs with a handful of large reads (or a single mmap) instead of one getline per line.
+ **/
+
+#include <stdlib.h>
+#include <memory.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "input.h"
+
+#define READ_SIZE (1 << 20) /**< Initial buffer size and minimal size of a single read */
+
+/**
+ * Map a regular file
+ *
+ * @brief Maps the rest of the file behind fd into memory
+ * @details Only works for regular files
+ *
+ * @param fd The file descriptor to map
+ * @param input The mapped input
+ * @return True if the file was mapped, false if it has to be read instead
+ */
+static bool map_file(int fd, input_t *input);
+
+/**
+ * Read once
+ *
+ * @brief Appends the result of a single large read to the input
+ * @details Grows the buffer, so that every read is at least READ_SIZE bytes large
+ *
+ * @param fd The file descriptor to read from
+ * @param input The input to append to
+ * @return False if EOF was reached, true otherwise
+ */
+static bool read_once(int fd, input_t *input);
+
+void input_read(int fd, input_t *input) {
+    if (input->data == NULL && map_file(fd, input)) return;
+
+    while (read_once(fd, input));
+}
+
+void input_read_line(int fd, input_t *input) {
+    size_t scanned = 0;
+
+    while (input->size == scanned || memchr(input->data + scanned, '\n', input->size - scanned) == NULL) {
+        scanned = input->size;
+        if (!read_once(fd, input)) return;
+    }
+}
+
+void input_free(input_t *input) {
+    if (input->map != NULL) {
+        munmap(input->map, input->maplen);
+    } else {
+        free(input->data);
+    }
+
+    input->data = NULL;
+    input->size = 0;
+    input->capacity = 0;
+    input->map = NULL;
+}
+
+long int input_split(char *in, size_t size, line_t *out, long int amount) {
+    char *pos = in, *end = in + size;
+    long int i;
+
+    for (i = 0; i < amount && pos < end; i++) {
+        // memchr is vectorized by the C library
+        char *newline = memchr(pos, '\n', (size_t) (end - pos));
+        if (newline == NULL) newline = end;
+
+        out[i].data = pos;
+        out[i].len = (size_t) (newline - pos);
+        pos = newline + 1;
+    }
+
+    return i;
+}
+
+static bool map_file(int fd, input_t *input) {
+    struct stat st;
+    off_t offset;
+
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode)) return false;
+    if ((offset = lseek(fd, 0, SEEK_CUR)) == -1 || offset >= st.st_size) return false;
+
+    // Mappings have to start at a page boundary
+    off_t start = offset - offset % sysconf(_SC_PAGESIZE);
+    size_t len = (size_t) (st.st_size - start);
+
+    void *map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, start);
+    if (map == MAP_FAILED) return false;
+
+    posix_madvise(map, len, POSIX_MADV_SEQUENTIAL);
+
+    input->map = map;
+    input->maplen = len;
+    input->data = (char *) map + (offset - start);
+    input->size = (size_t) (st.st_size - offset);
+    input->capacity = input->size;
+
+    return true;
+}
+
+static bool read_once(int fd, input_t *input) {
+    ssize_t r;
+
+    if (input->capacity - input->size < READ_SIZE) {
+        input->capacity = input->capacity == 0 ? READ_SIZE : input->capacity * 2;
+        if ((input->data = realloc(input->data, input->capacity)) == NULL) error_exit("Cannot allocate memory");
+    }
+
+    while ((r = read(fd, input->data + input->size, input->capacity - input->size)) == -1) {
+        if (errno != EINTR) error_exit("Cannot read input");
+    }
+
+    input->size += (size_t) r;
+
+    return r != 0;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file input.h
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Bulk input header.
+ *
+ * Declares functions that read a whole input into one buffer and index its lines in place.
+ **/
+
+#ifndef UE2_INPUT_H
+#define UE2_INPUT_H
+
+#include "main.h"
+
+/**
+ * @struct Input struct
+ * @brief A whole input held in one buffer
+ * @details Typedef as input_t
+ */
+typedef struct input {
+    char *data; /**< Input content */
+    size_t size; /**< Length of the content */
+    size_t capacity; /**< Size of the buffer */
+    void *map; /**< Start of the mapping if the content is mmapped, NULL if it is malloced */
+    size_t maplen; /**< Length of the mapping */
+} input_t;
+
+/**
+ * Read whole input
+ *
+ * @brief Reads everything from fd until EOF into one buffer
+ * @details Regular files are mmapped, everything else is read with large read calls.
+ *          If the input already holds content, e.g. from input_read_line, the rest is appended.
+ *          Exits on failure.
+ *
+ * @param fd The file descriptor to read from
+ * @param input The read input
+ */
+void input_read(int fd, input_t *input);
+
+/**
+ * Read first line
+ *
+ * @brief Reads from fd until the input contains a newline or EOF is reached
+ * @details May read more than the first line. Continue with input_read to read the rest.
+ *
+ * @param fd The file descriptor to read from
+ * @param input The input to read to, must be empty or malloced
+ */
+void input_read_line(int fd, input_t *input);
+
+/**
+ * Free input
+ *
+ * @brief Releases the buffer of an input read by input_read
+ *
+ * @param input The input to free
+ */
+void input_free(input_t *input);
+
+/**
+ * Split text into lines
+ *
+ * @brief Splits in into at most amount lines without copying
+ * @details The resulting lines point into in and do not contain the newline.
+ *          A last line without newline is accepted as well.
+ *
+ * @param in The text to split
+ * @param size The length of the text
+ * @param out The output array
+ * @param amount The maximal amount of lines to split
+ * @return The amount of lines actually split
+ */
+long int input_split(char *in, size_t size, line_t *out, long int amount);
+
+#endif //UE2_INPUT_H
@@ -0,0 +1,136 @@
+/**
+ * @file key.c
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Sort key module.
+ *
+ * Implements the field lookup and the binary normalization of sort keys.
+ **/
+
+#include <stdint.h>
+#include <memory.h>
+#include "key.h"
+
+/**
+ * Check for blank
+ *
+ * @brief Checks whether c separates fields if no separator is given
+ *
+ * @param c The character to check
+ * @return True for spaces and tabs
+ */
+static bool is_blank(char c);
+
+/**
+ * Find field
+ *
+ * @brief Sets the key of line to the field selected by options.field
+ * @details Missing fields result in an empty key
+ *
+ * @param line The line to search
+ */
+static void find_field(line_t *line);
+
+/**
+ * Parse number
+ *
+ * @brief Parses the leading number of a key, like sort -n does
+ * @details Leading blanks, a minus sign, digits and a decimal point are accepted.
+ *          Keys without a number have the value 0.
+ *
+ * @param key The key to parse
+ * @param len The length of the key
+ * @return The parsed value
+ */
+static double parse_number(const char *key, size_t len);
+
+void key_extract(line_t *lines, long int amount) {
+    for (long int i = 0; i < amount; i++) {
+        line_t *line = &lines[i];
+
+        find_field(line);
+
+        if (options.numeric) {
+            double value = parse_number(line->key, line->keylen);
+            uint64_t bits;
+
+            // -0 and 0 are equal
+            if (value == 0) value = 0;
+            memcpy(&bits, &value, sizeof bits);
+
+            // Flip negative numbers completely and positive numbers only in their sign, then store big endian
+            bits = (bits >> 63) ? ~bits : bits | ((uint64_t) 1 << 63);
+            for (int b = 0; b < KEY_PREFIX; b++) {
+                line->prefix[b] = (unsigned char) (bits >> (8 * (KEY_PREFIX - 1 - b)));
+            }
+        } else {
+            size_t len = line->keylen < KEY_PREFIX ? line->keylen : KEY_PREFIX;
+
+            memset(line->prefix, 0, KEY_PREFIX);
+            memcpy(line->prefix, line->key, len);
+        }
+    }
+}
+
+static bool is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static void find_field(line_t *line) {
+    const char *pos = line->data, *end = line->data + line->len, *start;
+
+    if (options.field == 0) {
+        line->key = line->data;
+        line->keylen = line->len;
+        return;
+    }
+
+    if (options.separator != 0) {
+        for (long int f = 1; f < options.field && pos < end; f++) {
+            const char *separator = memchr(pos, options.separator, (size_t) (end - pos));
+            pos = separator == NULL ? end : separator + 1;
+        }
+
+        start = pos;
+        pos = memchr(start, options.separator, (size_t) (end - start));
+        if (pos == NULL) pos = end;
+    } else {
+        start = pos;
+
+        for (long int f = 1; f <= options.field; f++) {
+            while (pos < end && is_blank(*pos)) pos++;
+            start = pos;
+            while (pos < end && !is_blank(*pos)) pos++;
+        }
+    }
+
+    line->key = start;
+    line->keylen = (size_t) (pos - start);
+}
+
+static double parse_number(const char *key, size_t len) {
+    const char *pos = key, *end = key + len;
+    double value = 0, scale = 1;
+    bool negative = false;
+
+    while (pos < end && is_blank(*pos)) pos++;
+
+    if (pos < end && *pos == '-') {
+        negative = true;
+        pos++;
+    }
+
+    for (; pos < end && *pos >= '0' && *pos <= '9'; pos++) {
+        value = value * 10 + (*pos - '0');
+    }
+
+    if (pos < end && *pos == '.') {
+        for (pos++; pos < end && *pos >= '0' && *pos <= '9'; pos++) {
+            scale /= 10;
+            value += (*pos - '0') * scale;
+        }
+    }
+
+    return negative ? -value : value;
+}
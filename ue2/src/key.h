@@ -0,0 +1,29 @@
+/**
+ * @file key.h
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Sort key header.
+ *
+ * Declares the key extraction that turns the sort options into a normalized binary prefix per line.
+ **/
+
+#ifndef UE2_KEY_H
+#define UE2_KEY_H
+
+#include "main.h"
+
+/**
+ * Extract sort keys
+ *
+ * @brief Locates the sort key of every line and stores its normalized prefix in the line
+ * @details Numerical keys are parsed once and encoded, so that they order correctly with memcmp.
+ *          Other keys store their first KEY_PREFIX bytes, padded with zeros.
+ *          Global variables: options
+ *
+ * @param lines The lines to extract the keys of
+ * @param amount The amount of lines
+ */
+void key_extract(line_t *lines, long int amount);
+
+#endif //UE2_KEY_H
@@ -12,10 +12,19 @@
 #include <stdlib.h>
 #include <memory.h>
 #include <stdbool.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/resource.h>
 #include "main.h"
+#include "frame.h"
+#include "input.h"
 #include "process.h"
 
+#define OPTION_MAX_PROCS (256) /**< getopt_long value of --max-procs */
+#define OPTION_MAX_FDS (257) /**< getopt_long value of --max-fds */
+
 char* pgm_name;
+options_t options;
 
 /**
  * Parses arguments from argc and argv
@@ -28,25 +37,29 @@ char* pgm_name;
 static void parse_arguments(int argc, char *argv[]);
 
 /**
- * Reads a number from stdin
+ * Reads a number from the input
  *
- * @brief Using the read_line function a number is read and converted
+ * @brief Parses the first line of the input as number
  * @details The result is stored to the parameter.
  *
+ * @param input The input to read from
+ * @param offset The offset of the first line after the number will be stored here
  * @param amount The read number
  */
-static void read_line_amount(long int *amount);
+static void read_line_amount(const input_t *input, size_t *offset, long int *amount);
 
 /**
- * Read multiple lines from stdin
+ * Read multiple lines from the input
  *
- * @brief Reads amount lines and stores them into lines
- * @details Using the read_line function
+ * @brief Indexes amount lines of the input starting at offset and stores them into lines
+ * @details Using the input_split function, so the lines point into the input
  *
+ * @param input The input to read from
+ * @param offset The offset of the first line
  * @param amount The amount of lines to read
  * @param lines The array to save the results to
  */
-static void read_lines(const long int *amount, char lines[][LINE_LENGTH]);
+static void read_lines(const input_t *input, size_t offset, const long int *amount, line_t *lines);
 
 /**
  * Program entry point.
@@ -61,19 +74,51 @@ int main(int argc, char *argv[]) {
     parse_arguments(argc, argv);
 
     long int amount;
-    read_line_amount(&amount);
+    line_t *lines;
+    input_t input = {0};
+
+    if (options.framed) {
+        lines = frame_read(STDIN_FILENO, &amount, &input.data);
+        if (amount < 1) error_exit("Line amount must be positive");
+    } else {
+        size_t offset;
 
-    char lines[amount][LINE_LENGTH];
+        input_read(STDIN_FILENO, &input);
+        read_line_amount(&input, &offset, &amount);
 
-    read_lines(&amount, lines);
+        lines = malloc(sizeof(line_t) * amount);
+        if (lines == NULL) error_exit("Cannot allocate memory");
+
+        read_lines(&input, offset, &amount, lines);
+    }
 
     forksort(amount, lines);
 
+    free(lines);
+    input_free(&input);
+
     return EXIT_SUCCESS;
 }
 
 void usage(void) {
-    fprintf(stderr, "SYNOPSIS:\n\t%s\n", pgm_name);
+    fprintf(stderr, "SYNOPSIS:\n\t%s [-b] [-F] [-z] [-a] [-j jobs] [-k field] [-t separator] [-n] [-r] [-u] [-l limit] [-T file]\n"
+                    "\t\t[--max-procs n] [--max-fds n]\n"
+                    "\t-b\tUse binary framing to communicate with child processes\n"
+                    "\t-F\tRead and write binary frames instead of text (used by child processes)\n"
+                    "\t-z\tMove data between processes with vmsplice and splice (Linux only)\n"
+                    "\t-a\tDetect presorted runs and merge them, sorted input needs no child processes\n"
+                    "\t-j\tMaximal amount of threads per merge, defaults to the amount of processors\n"
+                    "\t-k\tSort by the given field only, fields are counted from 1\n"
+                    "\t-t\tSeparate fields by the given character instead of blanks\n"
+                    "\t-n\tCompare by numerical value\n"
+                    "\t-r\tReverse the order, equal lines keep their input order\n"
+                    "\t-u\tOutput only the first of several lines with equal keys\n"
+                    "\t-l\tOutput only the first limit lines of the sorted result\n"
+                    "\t-T\tWrite the timings of every process in the Chrome trace event format to file\n"
+                    "\t-D\tDepth of this process in the tree (used by child processes)\n"
+                    "\t-P\tMaximal amount of live descendants (used by child processes)\n"
+                    "\t--max-procs\tMaximal amount of live processes, defaults to half of RLIMIT_NPROC\n"
+                    "\t--max-fds\tMaximal amount of open pipe ends of all processes\n", pgm_name);
     error_exit(NULL);
 }
 
@@ -85,15 +130,117 @@ void error_exit(char *message) {
 void parse_arguments(int argc, char *argv[]) {
     pgm_name = argv[0];
 
-    if (argc > 1) usage();
+    static const struct option long_options[] = {
+            {"max-procs", required_argument, NULL, OPTION_MAX_PROCS},
+            {"max-fds", required_argument, NULL, OPTION_MAX_FDS},
+            {NULL, 0, NULL, 0}
+    };
+
+    long int jobs = sysconf(_SC_NPROCESSORS_ONLN), procs = -1, fds = -1;
+    struct rlimit limit;
+    char *end;
+    int c;
+
+    // Leave half of the process limit to the other processes of the user
+    if (getrlimit(RLIMIT_NPROC, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) procs = (long int) (limit.rlim_cur / 2);
+
+    options.budget = -1;
+
+    while ((c = getopt_long(argc, argv, "bFzaj:k:t:nrul:T:D:P:", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'b':
+                options.binary = true;
+                break;
+            case 'F':
+                // Framed processes talk to their own children in frames as well
+                options.framed = true;
+                options.binary = true;
+                break;
+            case 'z':
+                options.zerocopy = true;
+                break;
+            case 'a':
+                options.adaptive = true;
+                break;
+            case 'j':
+                jobs = strtol(optarg, &end, 10);
+                if (*end != '\0' || jobs < 1) usage();
+                break;
+            case 'k':
+                options.field = strtol(optarg, &end, 10);
+                if (*end != '\0' || options.field < 1) usage();
+                break;
+            case 't':
+                if (strlen(optarg) != 1 || optarg[0] == '\n') usage();
+                options.separator = optarg[0];
+                break;
+            case 'n':
+                options.numeric = true;
+                break;
+            case 'r':
+                options.reverse = true;
+                break;
+            case 'u':
+                options.unique = true;
+                break;
+            case 'l':
+                options.limit = strtol(optarg, &end, 10);
+                if (*end != '\0' || options.limit < 1) usage();
+                break;
+            case 'T':
+                options.trace = optarg;
+                break;
+            case 'D':
+                options.depth = strtol(optarg, &end, 10);
+                if (*end != '\0' || options.depth < 0) usage();
+                break;
+            case 'P':
+                // Children get their budget from the parent, the limits only apply to the root
+                options.budget = strtol(optarg, &end, 10);
+                if (*end != '\0' || options.budget < 0) usage();
+                procs = fds = -1;
+                break;
+            case OPTION_MAX_PROCS:
+                procs = strtol(optarg, &end, 10);
+                if (*end != '\0' || procs < 1) usage();
+                break;
+            case OPTION_MAX_FDS:
+                fds = strtol(optarg, &end, 10);
+                if (*end != '\0' || fds < 0) usage();
+                break;
+            default:
+                usage();
+        }
+    }
+
+    options.jobs = jobs < 1 ? 1 : (int) jobs;
+
+    // The root process itself is not part of the budget
+    if (procs > 0 && (options.budget < 0 || procs - 1 < options.budget)) options.budget = procs - 1;
+    if (fds >= 0 && (options.budget < 0 || fds / PIPE_FDS_PER_CHILD < options.budget)) {
+        options.budget = fds / PIPE_FDS_PER_CHILD;
+    }
+
+    if (optind < argc) usage();
 }
 
-void read_line_amount(long int *amount) {
-    char *line;
+void read_line_amount(const input_t *input, size_t *offset, long int *amount) {
+    char line[32];
     char *ptr;
+    char *newline = memchr(input->data, '\n', input->size);
 
-    read_line(&line);
-    line[strcspn(line, "\n")] = 0;
+    if (newline == NULL) {
+        error_exit("Cannot read line");
+    }
+
+    size_t len = (size_t) (newline - input->data);
+
+    if (len == 0 || len >= sizeof line) {
+        error_exit("Provided line amount is not a number");
+    }
+
+    memcpy(line, input->data, len);
+    line[len] = 0;
 
     *amount = strtol(line, &ptr, 10);
 
@@ -105,38 +252,24 @@ void read_line_amount(long int *amount) {
         error_exit("Line amount must be positive");
     }
 
-    free(line);
-}
-
-void read_lines(const long int *amount, char lines[][LINE_LENGTH]) {
-    for (long int i = 0; i < *amount; i++) {
-        char *line;
-        bool empty = false;
-
-        read_line(&line);
-
-        if (line[0] == '\n') empty = true;
-
-        strcpy(lines[i], line);
+    *offset = len + 1;
 
-        free(line);
-
-        if (empty) {
-            error_exit("Empty line was provided");
-        }
+    // Every line takes at least one byte, so reject impossible amounts before allocating
+    if ((size_t) *amount > input->size - *offset) {
+        error_exit("Cannot read line");
     }
 }
 
-void read_line(char **lineptr) {
-    size_t len;
-
-    *lineptr = NULL;
+void read_lines(const input_t *input, size_t offset, const long int *amount, line_t *lines) {
+    long int read = input_split(input->data + offset, input->size - offset, lines, *amount);
 
-    if (getline(lineptr, &len, stdin) == -1) {
+    if (read < *amount) {
         error_exit("Cannot read line");
     }
 
-    if (strlen(*lineptr) == 0) {
-        error_exit("Read empty line");
+    for (long int i = 0; i < *amount; i++) {
+        if (lines[i].len == 0) {
+            error_exit("Empty line was provided");
+        }
     }
-}
\ No newline at end of file
+}
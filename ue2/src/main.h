@@ -11,9 +11,49 @@
 #ifndef UE2_MAIN_H
 #define UE2_MAIN_H
 
-#define LINE_LENGTH (62)
+#include <stdbool.h>
+#include <stddef.h>
+
+#define KEY_PREFIX (8) /**< Length of the normalized binary key prefix of a line */
+
+/**
+ * @struct Line struct
+ * @brief A single input line
+ * @details The content is neither null terminated nor does it contain the trailing newline.
+ *          The key fields are only valid after key_extract. Typedef as line_t
+ */
+typedef struct line {
+    char *data; /**< Line content */
+    size_t len; /**< Length of the line content */
+    const char *key; /**< Start of the sort key within the content */
+    size_t keylen; /**< Length of the sort key */
+    unsigned char prefix[KEY_PREFIX]; /**< Normalized key prefix that orders like the key when compared with memcmp */
+} line_t;
+
+/**
+ * @struct Options struct
+ * @brief Program options that are passed on to every child process
+ * @details Typedef as options_t
+ */
+typedef struct options {
+    bool binary; /**< Use length-prefixed binary framing to communicate with child processes */
+    bool framed; /**< Read from stdin and write to stdout using binary framing */
+    bool zerocopy; /**< Move data between processes with vmsplice and splice where possible */
+    int jobs; /**< Maximal amount of threads used for a single merge */
+    bool adaptive; /**< Merge existing runs instead of always splitting in the middle */
+    bool unique; /**< Output only the first of several lines with equal keys */
+    long int limit; /**< Output only the first limit lines, 0 for all lines */
+    char *trace; /**< Path of the Chrome trace file, NULL if tracing is disabled */
+    long int depth; /**< Depth of this process in the tree, 0 for the root */
+    long int budget; /**< Maximal amount of descendant processes alive at once, negative for no limit */
+    long int field; /**< Sort by this field only (1-based), 0 for the whole line */
+    char separator; /**< Field separator, 0 for runs of blanks */
+    bool numeric; /**< Compare keys by their numerical value */
+    bool reverse; /**< Reverse the result of comparisons */
+} options_t;
 
 extern char *pgm_name; /**< Program name */
+extern options_t options; /**< Parsed program options */
 
 /**
  * Mandatory usage function.
@@ -33,14 +73,4 @@ void usage(void);
  */
 void error_exit(char *message);
 
-/**
- * Read line to the given pointer.
- *
- * @brief Reads a line from stdin including newline
- * @details Allocates the references pointer. Must be feed manually.
- *
- * @param lineptr
- */
-void read_line(char **lineptr);
-
 #endif //UE2_MAIN_H
@@ -0,0 +1,310 @@
+/**
+ * @file merge.c
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Merge module.
+ *
+ * Implements the merge step of forksort, optionally split across threads with merge path partitioning.
+ **/
+
+#include <stdlib.h>
+#include <memory.h>
+#include <pthread.h>
+#include "merge.h"
+
+/**
+ * @struct Slice struct
+ * @brief Work of a single merge worker
+ * @details Typedef as slice_t
+ */
+typedef struct slice {
+    const line_t *left; /**< Whole left array */
+    long int llen; /**< Length of the left array */
+    const line_t *right; /**< Whole right array */
+    long int rlen; /**< Length of the right array */
+    line_t *out; /**< Whole output array */
+    long int begin; /**< First output index of this slice */
+    long int end; /**< Output index after the last one of this slice */
+} slice_t;
+
+/**
+ * Co-rank
+ *
+ * @brief Finds how many left lines are among the first diagonal lines of the merged output
+ * @details Binary search on the merge path, equal lines are taken from left first like in merge
+ *
+ * @param diagonal The amount of merged lines
+ * @param left Left array
+ * @param llen Length of left array
+ * @param right Right array
+ * @param rlen Length of right array
+ * @return The amount of left lines, the rest is taken from right
+ */
+static long int corank(long int diagonal, const line_t *left, long int llen, const line_t *right, long int rlen);
+
+/**
+ * Merge worker
+ *
+ * @brief Merges a single slice of the output
+ * @details Thread entry point
+ *
+ * @param arg The slice_t to merge
+ * @return NULL
+ */
+static void *merge_slice(void *arg);
+
+/**
+ * Compare heap entries
+ *
+ * @brief Compares two lines by their keys and by their index if the keys are equal
+ *
+ * @param lines The lines the indices refer to
+ * @param a Index of the first line
+ * @param b Index of the second line
+ * @return -1, 0 or 1 if a sorts before, equal to or after b
+ */
+static int compare_indexed(const line_t *lines, long int a, long int b);
+
+/**
+ * Restore heap order
+ *
+ * @brief Moves the entry at pos down until no child of it is greater
+ *
+ * @param lines The lines the heap entries refer to
+ * @param heap The max heap of line indices
+ * @param size The amount of heap entries
+ * @param pos The entry to move
+ */
+static void sift_down(const line_t *lines, long int *heap, long int size, long int pos);
+
+int compare_lines(const line_t *a, const line_t *b) {
+    int cmp = memcmp(a->prefix, b->prefix, KEY_PREFIX);
+
+    // Numerical keys are completely encoded in their prefix, other keys continue behind it
+    if (cmp == 0 && !options.numeric) {
+        size_t len = a->keylen < b->keylen ? a->keylen : b->keylen, offset = len < KEY_PREFIX ? len : KEY_PREFIX;
+
+        cmp = memcmp(a->key + offset, b->key + offset, len - offset);
+        if (cmp == 0) cmp = (a->keylen > b->keylen) - (a->keylen < b->keylen);
+    }
+
+    cmp = (cmp > 0) - (cmp < 0);
+
+    return options.reverse ? -cmp : cmp;
+}
+
+void merge(const line_t *left, long int llen, const line_t *right, long int rlen, line_t *out) {
+    long int i = 0, j = 0, k = 0;
+
+    while (i < llen && j < rlen) {
+        int cmp = compare_lines(&left[i], &right[j]);
+        if (cmp <= 0) {
+            out[k++] = left[i++];
+        } else {
+            out[k++] = right[j++];
+        }
+    }
+
+    // Copy remaining left elements if there are any
+    for (; i < llen; i++) {
+        out[k++] = left[i];
+    }
+
+    // Copy remaining right elements if there are any
+    for (; j < rlen; j++) {
+        out[k++] = right[j];
+    }
+}
+
+void merge_parallel(const line_t *left, long int llen, const line_t *right, long int rlen, line_t *out,
+                    int workers) {
+    merge_partial(left, llen, right, rlen, out, llen + rlen, workers);
+}
+
+void merge_partial(const line_t *left, long int llen, const line_t *right, long int rlen, line_t *out,
+                   long int amount, int workers) {
+    if (workers > amount / MERGE_MIN_SLICE) workers = (int) (amount / MERGE_MIN_SLICE);
+
+    if (workers <= 1 && amount == llen + rlen) {
+        merge(left, llen, right, rlen, out);
+        return;
+    }
+
+    // A single slice ending at amount stops the merge there
+    if (workers < 1) workers = 1;
+
+    slice_t *slices = malloc(sizeof(slice_t) * workers);
+    pthread_t *threads = malloc(sizeof(pthread_t) * workers);
+    if (slices == NULL || threads == NULL) error_exit("Cannot allocate memory");
+
+    for (int w = 0; w < workers; w++) {
+        slices[w] = (slice_t) {
+                .left = left, .llen = llen, .right = right, .rlen = rlen, .out = out,
+                .begin = amount * w / workers, .end = amount * (w + 1) / workers
+        };
+    }
+
+    // The calling thread merges the first slice itself
+    for (int w = 1; w < workers; w++) {
+        if (pthread_create(&threads[w], NULL, merge_slice, &slices[w]) != 0) error_exit("Cannot create thread");
+    }
+
+    merge_slice(&slices[0]);
+
+    for (int w = 1; w < workers; w++) {
+        if (pthread_join(threads[w], NULL) != 0) error_exit("Cannot join thread");
+    }
+
+    free(slices);
+    free(threads);
+}
+
+static long int corank(long int diagonal, const line_t *left, long int llen, const line_t *right, long int rlen) {
+    long int low = diagonal > rlen ? diagonal - rlen : 0, high = diagonal < llen ? diagonal : llen;
+
+    while (low < high) {
+        long int i = low + (high - low) / 2, j = diagonal - i;
+
+        // left[i] is merged before right[j - 1], so more than i left lines are part of the diagonal
+        if (compare_lines(&left[i], &right[j - 1]) <= 0) {
+            low = i + 1;
+        } else {
+            high = i;
+        }
+    }
+
+    return low;
+}
+
+static void *merge_slice(void *arg) {
+    slice_t *slice = arg;
+    long int lbegin = corank(slice->begin, slice->left, slice->llen, slice->right, slice->rlen);
+    long int lend = corank(slice->end, slice->left, slice->llen, slice->right, slice->rlen);
+    long int rbegin = slice->begin - lbegin, rend = slice->end - lend;
+
+    merge(slice->left + lbegin, lend - lbegin, slice->right + rbegin, rend - rbegin, slice->out + slice->begin);
+
+    return NULL;
+}
+
+long int select_lines(line_t *lines, long int amount, long int limit) {
+    long int size = amount < limit ? amount : limit;
+    long int *heap = malloc(sizeof(long int) * size);
+    line_t *selected = malloc(sizeof(line_t) * size);
+
+    if (heap == NULL || selected == NULL) error_exit("Cannot allocate memory");
+
+    for (long int i = 0; i < size; i++) heap[i] = i;
+    for (long int i = size / 2 - 1; i >= 0; i--) sift_down(lines, heap, size, i);
+
+    // Later lines only replace the greatest kept one if their key is strictly less, which keeps ties stable
+    for (long int i = size; i < amount; i++) {
+        if (compare_lines(&lines[i], &lines[heap[0]]) < 0) {
+            heap[0] = i;
+            sift_down(lines, heap, size, 0);
+        }
+    }
+
+    // Taking the greatest line first fills the selection from the back
+    for (long int n = size; n > 0; n--) {
+        selected[n - 1] = lines[heap[0]];
+        heap[0] = heap[n - 1];
+        sift_down(lines, heap, n - 1, 0);
+    }
+
+    memcpy(lines, selected, sizeof(line_t) * size);
+
+    free(heap);
+    free(selected);
+
+    return size;
+}
+
+static int compare_indexed(const line_t *lines, long int a, long int b) {
+    int cmp = compare_lines(&lines[a], &lines[b]);
+
+    return cmp != 0 ? cmp : (a > b) - (a < b);
+}
+
+static void sift_down(const line_t *lines, long int *heap, long int size, long int pos) {
+    for (;;) {
+        long int greatest = pos, child = 2 * pos + 1;
+
+        if (child < size && compare_indexed(lines, heap[child], heap[greatest]) > 0) greatest = child;
+        if (child + 1 < size && compare_indexed(lines, heap[child + 1], heap[greatest]) > 0) greatest = child + 1;
+
+        if (greatest == pos) return;
+
+        long int tmp = heap[pos];
+        heap[pos] = heap[greatest];
+        heap[greatest] = tmp;
+        pos = greatest;
+    }
+}
+
+long int unique_lines(line_t *lines, long int amount) {
+    long int kept = amount > 0 ? 1 : 0;
+
+    for (long int i = 1; i < amount; i++) {
+        if (compare_lines(&lines[kept - 1], &lines[i]) != 0) lines[kept++] = lines[i];
+    }
+
+    return kept;
+}
+
+long int find_runs(line_t *lines, long int amount, long int *starts) {
+    long int runs = 0, i = 0;
+
+    while (i < amount) {
+        long int start = i++;
+
+        if (i < amount && compare_lines(&lines[i - 1], &lines[i]) > 0) {
+            // Only strictly descending runs may be reversed without breaking stability
+            while (i < amount && compare_lines(&lines[i - 1], &lines[i]) > 0) i++;
+
+            for (long int l = start, r = i - 1; l < r; l++, r--) {
+                line_t tmp = lines[l];
+                lines[l] = lines[r];
+                lines[r] = tmp;
+            }
+        } else {
+            while (i < amount && compare_lines(&lines[i - 1], &lines[i]) <= 0) i++;
+        }
+
+        starts[runs++] = start;
+    }
+
+    starts[runs] = amount;
+
+    return runs;
+}
+
+void merge_runs(line_t *lines, long int amount, long int *starts, long int runs, int workers) {
+    line_t *buffer = malloc(sizeof(line_t) * amount), *from = lines, *to = buffer;
+
+    if (buffer == NULL) error_exit("Cannot allocate memory");
+
+    // Merge pairs of neighbouring runs until a single run is left
+    while (runs > 1) {
+        long int merged = 0;
+
+        for (long int r = 0; r < runs; r += 2) {
+            long int begin = starts[r], mid = starts[r + 1], end = r + 2 <= runs ? starts[r + 2] : mid;
+
+            merge_parallel(from + begin, mid - begin, from + mid, end - mid, to + begin, workers);
+            starts[merged++] = begin;
+        }
+
+        starts[merged] = amount;
+        runs = merged;
+
+        line_t *tmp = from;
+        from = to;
+        to = tmp;
+    }
+
+    if (from != lines) memcpy(lines, from, sizeof(line_t) * amount);
+
+    free(buffer);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file merge.h
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Merge header.
+ *
+ * Declares the line comparison and the sequential and parallel merges used by forksort.
+ **/
+
+#ifndef UE2_MERGE_H
+#define UE2_MERGE_H
+
+#include "main.h"
+
+#define MERGE_MIN_SLICE (1 << 16) /**< Minimal amount of lines merged by one worker of a parallel merge */
+
+/**
+ * Compare two lines
+ *
+ * @brief Compares the sort keys of two lines
+ * @details Compares the normalized prefixes first and the rest of the keys bytewise only if they are equal.
+ *          Both lines need extracted keys. Global variables: options
+ *
+ * @param a The first line
+ * @param b The second line
+ * @return -1, 0 or 1 if a sorts before, equal to or after b
+ */
+int compare_lines(const line_t *a, const line_t *b);
+
+/**
+ * Mergesort merge
+ *
+ * @brief Merges two sorted arrays into out
+ * @details This is a classic mergesort merge implementation. It is stable, equal lines are taken from left first.
+ *
+ * @param left Left partial array
+ * @param llen Length of left partial array
+ * @param right Right partial array
+ * @param rlen Length of right partial array
+ * @param out The output array, must hold llen + rlen lines
+ */
+void merge(const line_t *left, long int llen, const line_t *right, long int rlen, line_t *out);
+
+/**
+ * Parallel mergesort merge
+ *
+ * @brief Merges two sorted arrays into out using up to workers threads
+ * @details The output is cut into equal slices. Merge path partitioning (co-ranking) finds the part of
+ *          left and right that belongs to each slice with a binary search, so every worker merges its slice
+ *          independently. Falls back to merge if the arrays are too small to be worth splitting.
+ *          The result is identical to the one of merge.
+ *
+ * @param left Left partial array
+ * @param llen Length of left partial array
+ * @param right Right partial array
+ * @param rlen Length of right partial array
+ * @param out The output array, must hold llen + rlen lines
+ * @param workers The maximal amount of threads to use
+ */
+void merge_parallel(const line_t *left, long int llen, const line_t *right, long int rlen, line_t *out,
+                    int workers);
+
+/**
+ * Partial mergesort merge
+ *
+ * @brief Merges only the first amount lines of two sorted arrays into out using up to workers threads
+ * @details Works like merge_parallel, but the merge stops as soon as amount lines have been written.
+ *
+ * @param left Left partial array
+ * @param llen Length of left partial array
+ * @param right Right partial array
+ * @param rlen Length of right partial array
+ * @param out The output array, must hold amount lines
+ * @param amount The amount of lines to merge, at most llen + rlen
+ * @param workers The maximal amount of threads to use
+ */
+void merge_partial(const line_t *left, long int llen, const line_t *right, long int rlen, line_t *out,
+                   long int amount, int workers);
+
+/**
+ * Select the first lines
+ *
+ * @brief Moves the limit first lines in sorted order to the front of lines
+ * @details Uses a bounded max heap of limit lines, so only O(amount log limit) comparisons are needed.
+ *          Equal lines keep their order.
+ *
+ * @param lines The lines to select from, need extracted keys
+ * @param amount The amount of lines
+ * @param limit The amount of lines to select
+ * @return The amount of selected lines, which is less than limit if there are not enough lines
+ */
+long int select_lines(line_t *lines, long int amount, long int limit);
+
+/**
+ * Remove duplicates
+ *
+ * @brief Removes every line whose key equals the one of its predecessor from sorted lines in place
+ * @details The first of several equal lines is kept
+ *
+ * @param lines The sorted lines
+ * @param amount The amount of lines
+ * @return The amount of remaining lines
+ */
+long int unique_lines(line_t *lines, long int amount);
+
+/**
+ * Detect runs
+ *
+ * @brief Splits lines into maximal sorted runs
+ * @details Runs are either ascending or strictly descending. Descending runs are reversed in place, so
+ *          afterwards every run is sorted and equal lines keep their order.
+ *
+ * @param lines The lines to scan
+ * @param amount The amount of lines
+ * @param starts The start index of every run will be stored here, followed by amount. Must hold amount + 1 entries.
+ * @return The amount of runs
+ */
+long int find_runs(line_t *lines, long int amount, long int *starts);
+
+/**
+ * Natural mergesort
+ *
+ * @brief Sorts lines by repeatedly merging neighbouring runs
+ * @details Needs the runs found by find_runs, which are updated while merging. Large merges use up to
+ *          workers threads. The result is stable.
+ *
+ * @param lines The lines to sort
+ * @param amount The amount of lines
+ * @param starts The run starts as returned by find_runs
+ * @param runs The amount of runs
+ * @param workers The maximal amount of threads per merge
+ */
+void merge_runs(line_t *lines, long int amount, long int *starts, long int runs, int workers);
+
+#endif //UE2_MERGE_H
@@ -0,0 +1,139 @@
+/**
+ * @file output.c
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Batched output module.
+ *
+ * Turns one write per line into one write per buffer or batch of lines.
+ **/
+
+#include <stdlib.h>
+#include <memory.h>
+#include <unistd.h>
+#include <errno.h>
+#include "output.h"
+
+/**
+ * Write buffer
+ *
+ * @brief Writes all size bytes of buffer to fd
+ * @details Exits if a write fails
+ *
+ * @param fd The file descriptor to write to
+ * @param buffer The content to write
+ * @param size The length of the content
+ */
+static void write_buffer(int fd, const char *buffer, size_t size);
+
+void writer_open(writer_t *writer, int fd) {
+    writer->fd = fd;
+    writer->used = 0;
+
+    if ((writer->buffer = malloc(WRITER_SIZE)) == NULL) error_exit("Cannot allocate memory");
+}
+
+void writer_put(writer_t *writer, const void *data, size_t len) {
+    if (writer->used + len > WRITER_SIZE) {
+        write_buffer(writer->fd, writer->buffer, writer->used);
+        writer->used = 0;
+
+        // Do not copy what would not fit anyway
+        if (len > WRITER_SIZE) {
+            write_buffer(writer->fd, data, len);
+            return;
+        }
+    }
+
+    memcpy(writer->buffer + writer->used, data, len);
+    writer->used += len;
+}
+
+void writer_close(writer_t *writer) {
+    write_buffer(writer->fd, writer->buffer, writer->used);
+    free(writer->buffer);
+
+    writer->buffer = NULL;
+    writer->used = 0;
+}
+
+void write_vectors(int fd, struct iovec *iov, int count) {
+    while (count > 0) {
+        ssize_t w = writev(fd, iov, count);
+
+        if (w == -1) {
+            if (errno == EINTR) continue;
+            error_exit("Cannot write lines");
+        }
+
+        // Skip everything that was written and continue in the middle of a partially written vector
+        while (count > 0 && (size_t) w >= iov->iov_len) {
+            w -= iov->iov_len;
+            iov++;
+            count--;
+        }
+
+        if (count > 0) {
+            iov->iov_base = (char *) iov->iov_base + w;
+            iov->iov_len -= w;
+        }
+    }
+}
+
+void write_lines(int fd, const char *header, size_t headerlen, const line_t *lines, long int amount) {
+    struct iovec iov[BATCH_SIZE];
+    int count = 0;
+    bool joinable = false;
+
+    if (header != NULL) {
+        iov[count].iov_base = (char *) header;
+        iov[count].iov_len = headerlen;
+        count++;
+    }
+
+    for (long int i = 0; i < amount; i++) {
+        const line_t *line = &lines[i];
+
+        // Leave space for the line and its newline
+        if (count > BATCH_SIZE - 2) {
+            write_vectors(fd, iov, count);
+            count = 0;
+            joinable = false;
+        }
+
+        // A line that directly follows the previous vector in memory extends it
+        if (joinable && (char *) iov[count - 1].iov_base + iov[count - 1].iov_len == line->data) {
+            iov[count - 1].iov_len += line->len;
+        } else {
+            iov[count].iov_base = line->data;
+            iov[count].iov_len = line->len;
+            count++;
+        }
+
+        // Reuse the newline of the input if the next line follows it, so a slice of the input becomes one vector
+        joinable = i + 1 < amount && lines[i + 1].data == line->data + line->len + 1 && line->data[line->len] == '\n';
+
+        if (joinable) {
+            iov[count - 1].iov_len++;
+        } else {
+            iov[count].iov_base = "\n";
+            iov[count].iov_len = 1;
+            count++;
+        }
+    }
+
+    write_vectors(fd, iov, count);
+}
+
+static void write_buffer(int fd, const char *buffer, size_t size) {
+    size_t done = 0;
+
+    while (done < size) {
+        ssize_t w = write(fd, buffer + done, size - done);
+        if (w == -1) {
+            if (errno == EINTR) continue;
+            error_exit("Cannot write output");
+        }
+        done += (size_t) w;
+    }
+}
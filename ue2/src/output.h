@@ -0,0 +1,96 @@
+/**
+ * @file output.h
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Batched output header.
+ *
+ * Declares a buffered writer and functions that write many lines with few writev calls.
+ **/
+
+#ifndef UE2_OUTPUT_H
+#define UE2_OUTPUT_H
+
+#include <limits.h>
+#include <sys/uio.h>
+#include "main.h"
+
+#define WRITER_SIZE (1 << 20) /**< Buffer size of a writer */
+
+#ifdef IOV_MAX
+#define BATCH_SIZE (IOV_MAX) /**< Maximal amount of vectors per writev */
+#else
+#define BATCH_SIZE (1024) /**< Maximal amount of vectors per writev */
+#endif
+
+/**
+ * @struct Writer struct
+ * @brief Buffers small writes to a file descriptor
+ * @details Typedef as writer_t
+ */
+typedef struct writer {
+    int fd; /**< File descriptor to write to */
+    char *buffer; /**< Buffered content */
+    size_t used; /**< Amount of buffered bytes */
+} writer_t;
+
+/**
+ * Open writer
+ *
+ * @brief Initializes a writer for the given file descriptor
+ * @details Exits if the buffer cannot be allocated
+ *
+ * @param writer The writer to initialize
+ * @param fd The file descriptor to write to
+ */
+void writer_open(writer_t *writer, int fd);
+
+/**
+ * Write to writer
+ *
+ * @brief Appends len bytes to the buffer and writes it once it is full
+ * @details Content larger than the buffer is written directly
+ *
+ * @param writer The writer
+ * @param data The content to write
+ * @param len The length of the content
+ */
+void writer_put(writer_t *writer, const void *data, size_t len);
+
+/**
+ * Close writer
+ *
+ * @brief Writes the remaining buffer and frees it
+ * @details Does not close the file descriptor
+ *
+ * @param writer The writer to close
+ */
+void writer_close(writer_t *writer);
+
+/**
+ * Write vectors
+ *
+ * @brief Writes all count vectors with writev, continuing after partial writes
+ * @details The vectors are modified. Exits if a write fails.
+ *
+ * @param fd The file descriptor to write to
+ * @param iov The vectors to write
+ * @param count The amount of vectors
+ */
+void write_vectors(int fd, struct iovec *iov, int count);
+
+/**
+ * Write lines as text
+ *
+ * @brief Writes header followed by all lines, each terminated by a newline
+ * @details Lines are gathered into batches that are written with a single writev each
+ *
+ * @param fd The file descriptor to write to
+ * @param header Content to write before the lines, may be NULL
+ * @param headerlen Length of the header
+ * @param lines The lines to write
+ * @param amount The amount of lines
+ */
+void write_lines(int fd, const char *header, size_t headerlen, const line_t *lines, long int amount);
+
+#endif //UE2_OUTPUT_H
@@ -11,74 +11,165 @@
 #include <stdio.h>
 #include <sched.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <wait.h>
 #include <stdlib.h>
 #include <memory.h>
 #include <stdbool.h>
 #include "process.h"
+#include "frame.h"
+#include "input.h"
+#include "key.h"
+#include "merge.h"
+#include "output.h"
+#include "trace.h"
+#include "zerocopy.h"
+
+#define MAX_ARGUMENTS (32) /**< Maximal amount of arguments passed to a child */
+#define NATURAL_MAX_RUNS (64) /**< Inputs with at most this many runs are merged without children */
+#define LIMIT_LEAF (4) /**< With a limit, inputs of at most this many times the limit are sorted without children */
 
-#define BUFFER_SIZE (512)
+/**
+ * Sort node
+ *
+ * @brief Sorts the lines of this node and prints them, with the help of two children if necessary
+ * @details Records the timings of all phases with trace_event
+ *
+ * @param amount The amount of lines
+ * @param lines The lines to sort
+ */
+static void sort_node(long int amount, line_t *lines);
 
 /**
- * Tokenize string
+ * Sort without children
  *
- * @brief Splits in up into at most len parts and puts them into out
- * @details If there are more tokens than len, the rest will be ignored
+ * @brief Sorts lines within this process and prints them
+ * @details Merges the existing runs of the lines. With options.limit only the first limit lines are selected
+ *          with a bounded heap, unless options.unique is set, because duplicates would take up places of the heap.
  *
- * @param in The string to split
- * @param delim The delimiter to split at
- * @param out The output array
- * @param len The max amount of elements
+ * @param amount The amount of lines
+ * @param lines The lines to sort, are reordered
  */
-static void tokenize(char *in, const char *delim, char out[][LINE_LENGTH], long int len);
+static void sort_local(long int amount, line_t *lines);
+
+/**
+ * Natural merge
+ *
+ * @brief Sorts presorted lines without children by merging their existing runs
+ * @details Lines with more than NATURAL_MAX_RUNS runs are left to the children. In that case mid is moved to
+ *          the run boundary closest to it, so that each child receives whole runs.
+ *
+ * @param amount The amount of lines
+ * @param lines The lines to sort, descending runs are reversed in place
+ * @param mid The split position, may be changed
+ * @return True if the lines have been sorted and printed
+ */
+static bool natural_merge(long int amount, line_t *lines, long int *mid);
 
 /**
  * Mergesort merge
  *
  * @brief Performs the merging and prints the result to stdout
- * @details This is a classic mergesort merge implementation
+ * @details Large merges are split across options.jobs threads. With options.limit, the merge stops
+ *          after the lines that will be printed.
  *
  * @param left Left partial array
  * @param llen Length of left partial array
  * @param right Right partial array
  * @param rlen Length of right partial array
  */
-static void print_merge(char left[][LINE_LENGTH], long int llen, char right[][LINE_LENGTH], long int rlen);
+static void print_merge(line_t *left, long int llen, line_t *right, long int rlen);
+
+/**
+ * Forward without merging
+ *
+ * @brief Prints left followed by the output of the child behind pipefd if they are already in order
+ * @details Only the first line of the child is read. If it is not less than the last left line, the rest of
+ *          the output is forwarded to stdout with splice. Otherwise head holds what was read so far.
+ *
+ * @param left The sorted lines of the other child
+ * @param llen The amount of left lines
+ * @param pipefd The pipe of the child to forward
+ * @param head The read beginning of the child output will be stored here
+ * @return True if the output was forwarded, false if both halves have to be merged
+ */
+static bool forward_merge(line_t *left, long int llen, int pipefd[], input_t *head);
+
+/**
+ * Print lines
+ *
+ * @brief Writes the given lines to stdout
+ * @details Uses binary framing if options.framed is set and newline terminated text through a buffered writer otherwise.
+ *          If options.unique is set, duplicates are removed from the sorted lines first.
+ *          If options.limit is set, at most limit lines are printed.
+ *
+ * @param lines The sorted lines to print
+ * @param amount The amount of lines
+ */
+static void print_lines(line_t *lines, long int amount);
+
+/**
+ * Write lines to a child
+ *
+ * @brief Writes the line amount followed by the lines to the given pipe
+ * @details Uses binary framing if options.binary is set
+ *
+ * @param pipefd The pipe to write to
+ * @param lines The lines to write
+ * @param amount The amount of lines
+ */
+static void write_child(int pipefd[], const line_t *lines, long int amount);
+
+/**
+ * Read the result of a child
+ *
+ * @brief Reads the sorted lines from the given pipe
+ * @details The result points into the read input. The result is malloced and needs to be freed manually,
+ *          the input has to be released with input_free.
+ *
+ * @param pipefd The pipe to read from
+ * @param amount The amount of lines sent to the child. Is updated to the amount of lines returned,
+ *               which is less if options.unique removed duplicates or options.limit cut the output.
+ * @param input The read content will be stored here
+ * @return The read lines
+ */
+static line_t *read_lines(int pipefd[], long int *amount, input_t *input);
 
 /**
- * Read content from pipe
+ * Start child
  *
- * @brief Read pipe content into a single string and return
- * @details The result is malloced and needs to be freed manually
+ * @brief Creates the pipes of a child, forks it and closes the ends that belong to the child
  *
- * @param pipefd Rhe pipe to read from
- * @return The read string
+ * @param pid The childs pid will be stored here
+ * @param inpipefd The input pipe of the child will be stored here
+ * @param outpipefd The output pipe of the child will be stored here
+ * @param budget The process budget of the child, negative for no limit
  */
-static char *read_pipe(int pipefd[]);
+static void start_child(pid_t *pid, int inpipefd[], int outpipefd[], long int budget);
 
 /**
- * Write content to pipe
+ * Create pipe
  *
- * @brief Write up to len characters from out to the given pipe
- * @details Exits if write fails
+ * @brief Creates a pipe whose ends are closed on exec
+ * @details Children only keep the ends that are duplicated to stdin and stdout, so no child holds a
+ *          pipe of its sibling open and EOF is delivered as soon as the writer closes its end
  *
- * @param pipefd Pipe to write to
- * @param out The string to write
- * @param len The length of the string to write
+ * @param pipefd The created pipe
  */
-static void write_pipe(int pipefd[], char *out, size_t len);
+static void create_pipe(int pipefd[]);
 
 /**
  * Start recursive call to own executable
  *
  * @brief Fork process and execute program recursively
- * @details Child process calls this executable using execlp and pipes stdin and stdout
+ * @details Child process calls this executable using execvp and pipes stdin and stdout
  *
  * @param pid The childs pid will be stored here
  * @param inpipefd The opened input pipe
  * @param outpipefd The opened output pipe
+ * @param budget The process budget passed to the child, negative for no limit
  */
-static void fork_recursive(int *pid, int *inpipefd, int *outpipefd);
+static void fork_recursive(int *pid, int *inpipefd, int *outpipefd, long int budget);
 
 /**
  * Wait for child process
@@ -90,141 +181,289 @@ static void fork_recursive(int *pid, int *inpipefd, int *outpipefd);
  */
 static void wait_child(int pid);
 
-void forksort(long int amount, char lines[][LINE_LENGTH]) {
+void forksort(long int amount, line_t *lines) {
+    double start = trace_now();
+
+    if (options.depth == 0) trace_open();
+
+    sort_node(amount, lines);
+
+    // Children have been waited for, so the root is the last node to write
+    trace_node(start, amount);
+}
+
+static void sort_node(long int amount, line_t *lines) {
     // Termination condition
     if (amount == 1) {
-        printf("%s\n", lines[0]);
+        print_lines(lines, 1);
         return;
     }
 
-    long int mid = amount / 2 + (amount % 2), lamount = mid, ramount = amount - mid;
+    // Few lines more than the limit are not worth further processes, neither is anything without a budget
+    if ((options.limit > 0 && amount <= LIMIT_LEAF * options.limit) || options.budget == 0) {
+        sort_local(amount, lines);
+        return;
+    }
+
+    long int mid = amount / 2 + (amount % 2);
+
+    // Presorted input needs no children at all
+    if (options.adaptive && natural_merge(amount, lines, &mid)) return;
+
+    long int lamount = mid, ramount = amount - mid, lbudget = -1, rbudget = -1, budget = options.budget;
     int linpipefd[2], loutpipefd[2], rinpipefd[2], routpipefd[2];
     pid_t lpid, rpid;
-    char number[32], *delim = "\n";
-    char *lresult = NULL, *rresult = NULL;
-    char llines[lamount][LINE_LENGTH], rlines[ramount][LINE_LENGTH];
-
-    // Setup pipes
-    if (pipe(linpipefd) == -1 || pipe(loutpipefd) == -1 ||
-        pipe(rinpipefd) == -1 || pipe(routpipefd) == -1)
-        error_exit("Cannot create pipe");
+    input_t linput = {0}, rinput = {0};
+    line_t *llines, *rlines;
+    double start = trace_now();
+
+    // A subtree never needs more than 2 * amount processes, which also keeps the split below from overflowing
+    if (budget > 2 * amount) budget = 2 * amount;
+
+    // Both children need a process each, the rest of the budget is split by their amount of lines
+    bool sequential = budget == 1;
+    if (budget >= 2) {
+        lbudget = (budget - 2) * lamount / amount;
+        rbudget = budget - 2 - lbudget;
+    } else if (sequential) {
+        lbudget = rbudget = 0;
+    }
 
-    // Fork left process
-    fork_recursive(&lpid, linpipefd, loutpipefd);
+    // A sequential node starts the right child after the left one finished
+    start_child(&lpid, linpipefd, loutpipefd, lbudget);
+    if (!sequential) start_child(&rpid, rinpipefd, routpipefd, rbudget);
 
-    // Fork right process
-    fork_recursive(&rpid, rinpipefd, routpipefd);
+    trace_event("fork", start, amount);
+    start = trace_now();
 
-    // Close unused pipe ends
-    close(linpipefd[0]);
-    close(loutpipefd[1]);
-    close(rinpipefd[0]);
-    close(routpipefd[1]);
+    // Write the first half of lines to the left pipe and the second to the right pipe
+    write_child(linpipefd, lines, lamount);
+    if (!sequential) write_child(rinpipefd, lines + mid, ramount);
 
-    // Write line amount to left pipe
-    int b = snprintf(number, 32, "%ld\n", mid);
-    write_pipe(linpipefd, number, (size_t) b);
+    trace_event("write", start, amount);
+    start = trace_now();
 
-    // Write line amount to right pipe
-    b = snprintf(number, 32, "%ld\n", amount - mid);
-    write_pipe(rinpipefd, number, (size_t) b);
+    // Read the results before waiting, so no child blocks on a full pipe
+    llines = read_lines(loutpipefd, &lamount, &linput);
 
-    // Write the first half of lines to the left pipe and the second to the right pipe
-    for (long int i = 0; i < lamount; i++) {
-        char *line = lines[i];
-        write_pipe(linpipefd, line, strlen(line));
+    if (sequential) {
+        wait_child(lpid);
+        start_child(&rpid, rinpipefd, routpipefd, rbudget);
+        write_child(rinpipefd, lines + mid, ramount);
     }
 
-    for (long int i = 0; i < ramount; i++) {
-        char *line = lines[mid + i];
-        write_pipe(rinpipefd, line, strlen(line));
-    }
+    // Text output of the right child can be passed on as it is if it belongs behind the left one
+    bool forwarded = options.zerocopy && !options.binary && options.limit == 0 &&
+                     forward_merge(llines, lamount, routpipefd, &rinput);
+    rlines = forwarded ? NULL : read_lines(routpipefd, &ramount, &rinput);
+
+    trace_event(forwarded ? "forward" : "read", start, lamount + ramount);
+    start = trace_now();
 
     // Wait for children
-    wait_child(lpid);
+    if (!sequential) wait_child(lpid);
     wait_child(rpid);
 
-    // Read result of left child into a single string
-    lresult = read_pipe(loutpipefd);
-    rresult = read_pipe(routpipefd);
-
-    // Tokenize both results
-    tokenize(lresult, delim, llines, lamount);
-    tokenize(rresult, delim, rlines, ramount);
+    trace_event("wait", start, amount);
+    start = trace_now();
 
     // Merge both results together
-    print_merge(llines, lamount, rlines, ramount);
+    if (!forwarded) {
+        print_merge(llines, lamount, rlines, ramount);
+        trace_event("merge", start, lamount + ramount);
+    }
 
     // Free resources
-    free(lresult);
-    free(rresult);
+    free(llines);
+    free(rlines);
+    input_free(&linput);
+    input_free(&rinput);
 }
 
-static void tokenize(char *in, const char *delim, char out[][LINE_LENGTH], long int len) {
-    char *token = strtok(in, delim);
+static void sort_local(long int amount, line_t *lines) {
+    double start = trace_now();
+
+    key_extract(lines, amount);
+
+    if (options.limit > 0 && !options.unique) {
+        amount = select_lines(lines, amount, options.limit);
+    } else {
+        long int *starts = malloc(sizeof(long int) * (amount + 1));
+        if (starts == NULL) error_exit("Cannot allocate memory");
 
-    for (int i = 0; token != NULL; i++) {
-        if (i == len) break; // out is full
-        strncpy(out[i], token, LINE_LENGTH);
-        token = strtok(NULL, delim);
+        merge_runs(lines, amount, starts, find_runs(lines, amount, starts), options.jobs);
+        free(starts);
     }
+
+    print_lines(lines, amount);
+
+    trace_event("local", start, amount);
 }
 
-static void print_merge(char left[][LINE_LENGTH], long int llen, char right[][LINE_LENGTH], long int rlen) {
-    long int i = 0, j = 0;
-
-    while (i < llen && j < rlen) {
-        char *lline = left[i], *rline = right[j];
-        int cmp = strcmp(lline, rline);
-        if (cmp <= 0) {
-            printf("%s\n", lline);
-            i++;
-        } else {
-            printf("%s\n", rline);
-            j++;
-        }
-    }
+static bool natural_merge(long int amount, line_t *lines, long int *mid) {
+    long int *starts = malloc(sizeof(long int) * (amount + 1)), runs;
+    double start = trace_now();
+
+    if (starts == NULL) error_exit("Cannot allocate memory");
+
+    key_extract(lines, amount);
+    runs = find_runs(lines, amount, starts);
+
+    if (runs <= NATURAL_MAX_RUNS) {
+        merge_runs(lines, amount, starts, runs, options.jobs);
+        print_lines(lines, amount);
+        free(starts);
 
-    // Copy remaining left elements if there are any
-    for (; i < llen; i++) {
-        printf("%s\n", left[i]);
+        trace_event("natural", start, amount);
+        return true;
     }
 
-    // Copy remaining right elements if there are any
-    for (; j < rlen; j++) {
-        printf("%s\n", right[j]);
+    // Split at the run boundary closest to the middle, runs > 1 guarantees that there is one
+    long int best = starts[1];
+    for (long int r = 2; r < runs; r++) {
+        if (labs(starts[r] - *mid) < labs(best - *mid)) best = starts[r];
     }
+
+    *mid = best;
+    free(starts);
+
+    return false;
 }
 
-static char *read_pipe(int pipefd[]) {
-    char buffer[BUFFER_SIZE], *result = NULL;
-    int counter = 1;
+static void print_merge(line_t *left, long int llen, line_t *right, long int rlen) {
+    long int amount = llen + rlen;
+
+    // Duplicates are only removed after merging, so the merge cannot stop early with them
+    if (options.limit > 0 && !options.unique && amount > options.limit) amount = options.limit;
+
+    line_t *merged = malloc(sizeof(line_t) * amount);
+
+    if (merged == NULL) error_exit("Cannot allocate memory");
+
+    merge_partial(left, llen, right, rlen, merged, amount, options.jobs);
+
+    print_lines(merged, amount);
+
+    free(merged);
+}
+
+static bool forward_merge(line_t *left, long int llen, int pipefd[], input_t *head) {
+    line_t first;
+
+    input_read_line(pipefd[0], head);
+
+    if (input_split(head->data, head->size, &first, 1) != 1) return false;
+    key_extract(&first, 1);
+
+    // Without duplicates the first line has to be strictly greater
+    int cmp = compare_lines(&left[llen - 1], &first);
+    if (cmp > 0 || (options.unique && cmp == 0)) return false;
+
+    struct iovec iov = {head->data, head->size};
+
+    print_lines(left, llen);
+    write_vectors(STDOUT_FILENO, &iov, 1);
+    zerocopy_forward(pipefd[0], STDOUT_FILENO);
 
-    // Clear buffer
-    memset(&buffer, 0, BUFFER_SIZE);
+    close(pipefd[0]);
 
-    // Read result of left child into a single string
-    while (read(pipefd[0], &buffer, BUFFER_SIZE) > 0) {
-        bool first = result == NULL;
-        result = realloc(result, sizeof(char) * BUFFER_SIZE * counter++);
-        if (first) strcpy(result, buffer);
-        else strcat(result, buffer);
+    return true;
+}
+
+static void print_lines(line_t *lines, long int amount) {
+    // Duplicates are dropped here, so they are never sent further up the tree
+    if (options.unique) amount = unique_lines(lines, amount);
+    if (options.limit > 0 && amount > options.limit) amount = options.limit;
+
+    if (options.framed) {
+        frame_write(STDOUT_FILENO, lines, amount);
+        return;
+    }
+
+    writer_t writer;
+    writer_open(&writer, STDOUT_FILENO);
+
+    for (long int i = 0; i < amount; i++) {
+        writer_put(&writer, lines[i].data, lines[i].len);
+        writer_put(&writer, "\n", 1);
+    }
+
+    writer_close(&writer);
+}
+
+static void write_child(int pipefd[], const line_t *lines, long int amount) {
+    if (options.binary) {
+        // Only frames read from stdin are laid out like the records sent to the child
+        if (!options.zerocopy || !options.framed || !zerocopy_frame(pipefd[1], lines, amount)) {
+            frame_write(pipefd[1], lines, amount);
+        }
+    } else {
+        char number[32];
+        int b = snprintf(number, 32, "%ld\n", amount);
+
+        if (!options.zerocopy || !zerocopy_lines(pipefd[1], number, (size_t) b, lines, amount)) {
+            write_lines(pipefd[1], number, (size_t) b, lines, amount);
+        }
     }
 
-    return result;
+    // Signal EOF to the child
+    close(pipefd[1]);
 }
 
-static void write_pipe(int pipefd[], char *out, size_t len) {
-    if ((write(pipefd[1], out, len)) == -1) {
-        error_exit("Cannot write line to child");
+static line_t *read_lines(int pipefd[], long int *amount, input_t *input) {
+    line_t *lines;
+    long int read, expected = options.limit > 0 && *amount > options.limit ? options.limit : *amount;
+
+    if (options.binary) {
+        lines = frame_read(pipefd[0], &read, &input->data);
+    } else {
+        lines = malloc(sizeof(line_t) * expected);
+        if (lines == NULL) error_exit("Cannot allocate memory");
+
+        input_read(pipefd[0], input);
+        read = input_split(input->data, input->size, lines, expected);
+    }
+
+    // Only duplicates may be missing
+    if (read > expected || read < 1 || (read < expected && !options.unique)) {
+        error_exit("Child returned wrong amount of lines");
     }
+
+    *amount = read;
+    key_extract(lines, read);
+
+    close(pipefd[0]);
+
+    return lines;
+}
+
+static void start_child(pid_t *pid, int inpipefd[], int outpipefd[], long int budget) {
+    create_pipe(inpipefd);
+    create_pipe(outpipefd);
+
+    fork_recursive(pid, inpipefd, outpipefd, budget);
+
+    // Close unused pipe ends
+    close(inpipefd[0]);
+    close(outpipefd[1]);
+}
+
+static void create_pipe(int pipefd[]) {
+    if (pipe(pipefd) == -1) error_exit("Cannot create pipe");
+
+    if (fcntl(pipefd[0], F_SETFD, FD_CLOEXEC) == -1 || fcntl(pipefd[1], F_SETFD, FD_CLOEXEC) == -1)
+        error_exit("Cannot configure pipe");
 }
 
-static void fork_recursive(int *pid, int *inpipefd, int *outpipefd) {
+static void fork_recursive(int *pid, int *inpipefd, int *outpipefd, long int budget) {
     *pid = fork();
     if (*pid == -1) error_exit("Cannot fork child");
 
     if (*pid == 0) {
+        char *argv[MAX_ARGUMENTS], jobs[32], field[32], limit[32], depth[32], procs[32];
+        char separator[2] = {options.separator, 0};
+        int argc = 0;
+
         // Child process
         close(inpipefd[1]); // Only read from input pipe
         dup2(inpipefd[0], STDIN_FILENO); // Redirect read end to stdin
@@ -232,8 +471,55 @@ static void fork_recursive(int *pid, int *inpipefd, int *outpipefd) {
         close(outpipefd[0]); // Only write to output pipe
         dup2(outpipefd[1], STDOUT_FILENO); // Redirect stdout to write end
 
+        // Pass on all options, children talk to their parent in frames if requested
+        argv[argc++] = pgm_name;
+        if (options.binary) argv[argc++] = "-F";
+        if (options.zerocopy) argv[argc++] = "-z";
+        if (options.adaptive) argv[argc++] = "-a";
+        if (options.unique) argv[argc++] = "-u";
+
+        snprintf(jobs, sizeof jobs, "%d", options.jobs);
+        argv[argc++] = "-j";
+        argv[argc++] = jobs;
+
+        if (options.field > 0) {
+            snprintf(field, sizeof field, "%ld", options.field);
+            argv[argc++] = "-k";
+            argv[argc++] = field;
+        }
+
+        if (options.separator != 0) {
+            argv[argc++] = "-t";
+            argv[argc++] = separator;
+        }
+
+        if (options.numeric) argv[argc++] = "-n";
+        if (options.reverse) argv[argc++] = "-r";
+
+        if (options.limit > 0) {
+            snprintf(limit, sizeof limit, "%ld", options.limit);
+            argv[argc++] = "-l";
+            argv[argc++] = limit;
+        }
+
+        if (options.trace != NULL) {
+            snprintf(depth, sizeof depth, "%ld", options.depth + 1);
+            argv[argc++] = "-T";
+            argv[argc++] = options.trace;
+            argv[argc++] = "-D";
+            argv[argc++] = depth;
+        }
+
+        if (budget >= 0) {
+            snprintf(procs, sizeof procs, "%ld", budget);
+            argv[argc++] = "-P";
+            argv[argc++] = procs;
+        }
+
+        argv[argc] = NULL;
+
         // Recursive call to own process
-        execlp(pgm_name, pgm_name, NULL);
+        execvp(pgm_name, argv);
 
         // We only get to this point of exec fails
         error_exit("Child's exec failed");
@@ -249,4 +535,4 @@ static void wait_child(int pid) {
 
     // Check if child exited successful
     if (WEXITSTATUS(status) != EXIT_SUCCESS) error_exit("Child exited with failure code");
-}
\ No newline at end of file
+}
@@ -5,7 +5,7 @@
  *
  * @brief Subprocess header.
  *
- * This header declares the subprocess functions that are required for this task and a custom char array structure.
+ * This header declares the subprocess functions that are required for this task.
  **/
 
 #ifndef UE2_PROCESS_H
@@ -13,16 +13,20 @@
 
 #include "main.h"
 
+#define PIPE_FDS_PER_CHILD (4) /**< Pipe ends held open by a child and its parent for each child process */
+
 /**
  * Interprocess mergesort variant
  *
  * @brief Sorts the given lines array using a mergesort variant.
- * @details Instead of normal recursion, a recursive child process is called
- *          Global variables: pgm_name
+ * @details Instead of normal recursion, a recursive child process is called.
+ *          At most options.budget descendants are alive at the same time, subtrees run sequentially
+ *          or without children once the budget is used up.
+ *          Global variables: pgm_name, options
  *
  * @param amount The amount of lines
  * @param lines The lines to sort
  */
-void forksort(long int amount, char lines[][LINE_LENGTH]);
+void forksort(long int amount, line_t *lines);
 
 #endif //UE2_PROCESS_H
@@ -0,0 +1,118 @@
+/**
+ * @file trace.c
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Process tree tracing module.
+ *
+ * Collects the events of a node in memory and appends them to the shared trace file once the node is done.
+ * The file is a JSON array of Chrome trace events, which can be opened in chrome://tracing or Perfetto.
+ **/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include "trace.h"
+#include "output.h"
+
+static char *events = NULL; /**< JSON of the events recorded so far */
+static size_t used = 0; /**< Length of the recorded JSON */
+static size_t capacity = 0; /**< Allocated size of events */
+
+/**
+ * Append JSON
+ *
+ * @brief Appends formatted text to the recorded events
+ *
+ * @param format The printf format
+ * @param ... The format arguments
+ */
+static void append(const char *format, ...);
+
+/**
+ * Write to the trace file
+ *
+ * @brief Writes len bytes of data to the trace file with a single writev
+ * @details The file is opened with O_APPEND, so writes of different nodes never mix
+ *
+ * @param flags Additional open flags
+ * @param data The data to write
+ * @param len The amount of bytes
+ */
+static void write_trace(int flags, char *data, size_t len);
+
+void trace_open(void) {
+    if (options.trace == NULL) return;
+
+    write_trace(O_CREAT | O_TRUNC, "[\n", 2);
+}
+
+double trace_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec * 1e6 + (double) now.tv_nsec / 1e3;
+}
+
+void trace_event(const char *name, double start, long int lines) {
+    if (options.trace == NULL) return;
+
+    append("{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d,"
+           "\"args\":{\"depth\":%ld,\"lines\":%ld}},\n",
+           name, start, trace_now() - start, (int) getpid(), (int) getpid(), options.depth, lines);
+}
+
+void trace_node(double start, long int lines) {
+    if (options.trace == NULL) return;
+
+    append("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"depth %ld\"}},\n",
+           (int) getpid(), (int) getpid(), options.depth);
+    trace_event("forksort", start, lines);
+
+    // The root writes last, so its final event closes the array
+    if (options.depth == 0) {
+        used -= 2;
+        append("\n]\n");
+    }
+
+    write_trace(0, events, used);
+
+    free(events);
+    events = NULL;
+    used = capacity = 0;
+}
+
+static void append(const char *format, ...) {
+    va_list args;
+
+    for (;;) {
+        va_start(args, format);
+        int len = vsnprintf(events == NULL ? NULL : events + used, capacity - used, format, args);
+        va_end(args);
+
+        if (len < 0) error_exit("Cannot format trace event");
+        if ((size_t) len < capacity - used) {
+            used += (size_t) len;
+            return;
+        }
+
+        capacity = capacity * 2 + (size_t) len + 1;
+        events = realloc(events, capacity);
+        if (events == NULL) error_exit("Cannot allocate memory");
+    }
+}
+
+static void write_trace(int flags, char *data, size_t len) {
+    int fd = open(options.trace, O_WRONLY | O_APPEND | flags, 0644);
+    struct iovec iov = {data, len};
+
+    if (fd == -1) error_exit("Cannot open trace file");
+
+    write_vectors(fd, &iov, 1);
+
+    close(fd);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file trace.h
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Process tree tracing header.
+ *
+ * Declares the recording of per node timings, which are exported in the Chrome trace event format.
+ **/
+
+#ifndef UE2_TRACE_H
+#define UE2_TRACE_H
+
+#include "main.h"
+
+/**
+ * Open trace
+ *
+ * @brief Creates or truncates the trace file and starts the JSON array
+ * @details Does nothing unless options.trace is set. Must only be called by the root node.
+ */
+void trace_open(void);
+
+/**
+ * Current time
+ *
+ * @brief Returns the monotonic time in microseconds, which is comparable between processes
+ *
+ * @return The current time
+ */
+double trace_now(void);
+
+/**
+ * Record event
+ *
+ * @brief Records a phase of this node that started at start and ends now
+ * @details Does nothing unless options.trace is set. Events are kept in memory until trace_node.
+ *
+ * @param name The name of the phase
+ * @param start The start time as returned by trace_now
+ * @param lines The amount of lines handled by the phase
+ */
+void trace_event(const char *name, double start, long int lines);
+
+/**
+ * Record node
+ *
+ * @brief Records the whole node and appends all its events to the trace file with a single write
+ * @details Does nothing unless options.trace is set. The root node (options.depth 0) closes the JSON array
+ *          after its own events, so it has to be the last node to call this.
+ *
+ * @param start The start time of the node as returned by trace_now
+ * @param lines The amount of lines sorted by the node
+ */
+void trace_node(double start, long int lines);
+
+#endif //UE2_TRACE_H
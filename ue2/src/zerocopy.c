@@ -0,0 +1,152 @@
+/**
+ * @file zerocopy.c
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Zero-copy transfer module.
+ *
+ * Uses vmsplice to map input pages into a child's pipe instead of copying them, and splice to move
+ * a child's output to stdout without passing it through user space.
+ **/
+
+#define _GNU_SOURCE /**< vmsplice and splice are Linux extensions */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include "zerocopy.h"
+#include "frame.h"
+#include "output.h"
+
+#define FORWARD_SIZE (1 << 20) /**< Maximal amount of bytes moved by one splice or read */
+
+/**
+ * Check line layout
+ *
+ * @brief Checks whether each line starts exactly gap bytes after the end of its predecessor
+ *
+ * @param lines The lines to check
+ * @param amount The amount of lines
+ * @param gap The amount of bytes between two lines
+ * @return True if the lines form one contiguous block
+ */
+static bool contiguous(const line_t *lines, long int amount, size_t gap);
+
+/**
+ * Hand memory to a pipe
+ *
+ * @brief Maps len bytes at data into the pipe with vmsplice
+ * @details Writes the rest regularly if vmsplice is not supported. Exits on failure.
+ *
+ * @param fd The pipe to write to
+ * @param data The memory to hand over
+ * @param len The amount of bytes
+ */
+static void vmsplice_full(int fd, char *data, size_t len);
+
+bool zerocopy_lines(int fd, const char *header, size_t headerlen, const line_t *lines, long int amount) {
+#ifdef __linux__
+    if (amount < 1 || !contiguous(lines, amount, 1)) return false;
+
+    // The gaps have to be the newlines of the input
+    for (long int i = 0; i < amount - 1; i++) {
+        if (lines[i].data[lines[i].len] != '\n') return false;
+    }
+
+    // The last line may be the end of the input, so its newline is always written separately
+    struct iovec iov[2] = {{(char *) header, headerlen}, {"\n", 1}};
+    char *start = lines[0].data;
+
+    write_vectors(fd, &iov[0], 1);
+    vmsplice_full(fd, start, (size_t) (lines[amount - 1].data + lines[amount - 1].len - start));
+    write_vectors(fd, &iov[1], 1);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool zerocopy_frame(int fd, const line_t *lines, long int amount) {
+#ifdef __linux__
+    if (amount < 1 || !contiguous(lines, amount, sizeof(frame_length_t))) return false;
+
+    // Records are preceded by their length prefix
+    char *start = lines[0].data - sizeof(frame_length_t);
+    frame_header_t header = {.count = (uint64_t) amount};
+    header.bytes = (uint64_t) (lines[amount - 1].data + lines[amount - 1].len - start);
+
+    struct iovec iov = {&header, sizeof header};
+
+    write_vectors(fd, &iov, 1);
+    vmsplice_full(fd, start, (size_t) header.bytes);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void zerocopy_forward(int in, int out) {
+    ssize_t r;
+
+#ifdef __linux__
+    while ((r = splice(in, NULL, out, NULL, FORWARD_SIZE, SPLICE_F_MOVE | SPLICE_F_MORE)) != 0) {
+        if (r == -1) {
+            if (errno == EINTR) continue;
+            // out does not support splice, copy the rest
+            if (errno == EINVAL) break;
+            error_exit("Cannot forward child output");
+        }
+    }
+
+    if (r == 0) return;
+#endif
+
+    char *buffer = malloc(FORWARD_SIZE);
+    if (buffer == NULL) error_exit("Cannot allocate memory");
+
+    while ((r = read(in, buffer, FORWARD_SIZE)) != 0) {
+        if (r == -1) {
+            if (errno == EINTR) continue;
+            error_exit("Cannot forward child output");
+        }
+
+        struct iovec iov = {buffer, (size_t) r};
+        write_vectors(out, &iov, 1);
+    }
+
+    free(buffer);
+}
+
+static bool contiguous(const line_t *lines, long int amount, size_t gap) {
+    for (long int i = 0; i < amount - 1; i++) {
+        if (lines[i + 1].data != lines[i].data + lines[i].len + gap) return false;
+    }
+
+    return true;
+}
+
+static void vmsplice_full(int fd, char *data, size_t len) {
+#ifdef __linux__
+    struct iovec iov = {data, len};
+
+    while (iov.iov_len > 0) {
+        ssize_t w = vmsplice(fd, &iov, 1, 0);
+
+        if (w == -1) {
+            if (errno == EINTR) continue;
+            // Not supported, write the rest regularly
+            write_vectors(fd, &iov, 1);
+            return;
+        }
+
+        iov.iov_base = (char *) iov.iov_base + w;
+        iov.iov_len -= (size_t) w;
+    }
+#else
+    struct iovec iov = {data, len};
+    write_vectors(fd, &iov, 1);
+#endif
+}
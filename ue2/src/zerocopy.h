@@ -0,0 +1,60 @@
+/**
+ * @file zerocopy.h
+ * @author Stefan Geyer <e1625718 at student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Zero-copy transfer header.
+ *
+ * Declares functions that move line data between processes with vmsplice and splice instead of write and read.
+ * These calls only exist on Linux, everywhere else the functions report that the regular path has to be used.
+ **/
+
+#ifndef UE2_ZEROCOPY_H
+#define UE2_ZEROCOPY_H
+
+#include "main.h"
+
+/**
+ * Hand text lines to a pipe
+ *
+ * @brief Writes header followed by the newline terminated lines, handing the lines to the pipe with vmsplice
+ * @details Only works if the lines still lie in the input buffer back to back, separated by their newlines.
+ *          The pipe references the pages of the buffer afterwards, so it must not be modified or freed until
+ *          the reader has consumed everything.
+ *
+ * @param fd The pipe to write to
+ * @param header Content to write before the lines
+ * @param headerlen Length of the header
+ * @param lines The lines to write
+ * @param amount The amount of lines
+ * @return False if nothing was written and the lines have to be written regularly
+ */
+bool zerocopy_lines(int fd, const char *header, size_t headerlen, const line_t *lines, long int amount);
+
+/**
+ * Hand framed lines to a pipe
+ *
+ * @brief Writes a frame header followed by the records of lines, handing the records to the pipe with vmsplice
+ * @details Only works if lines were read by frame_read and still lie in its buffer back to back.
+ *          The same restrictions as for zerocopy_lines apply.
+ *
+ * @param fd The pipe to write to
+ * @param lines The lines to write
+ * @param amount The amount of lines
+ * @return False if nothing was written and the lines have to be written regularly
+ */
+bool zerocopy_frame(int fd, const line_t *lines, long int amount);
+
+/**
+ * Forward pipe content
+ *
+ * @brief Moves everything from the pipe in to out until EOF using splice
+ * @details Falls back to read and write if out does not support splice, e.g. because it is a terminal.
+ *          Exits on failure.
+ *
+ * @param in The pipe to read from
+ * @param out The file descriptor to write to
+ */
+void zerocopy_forward(int in, int out);
+
+#endif //UE2_ZEROCOPY_H
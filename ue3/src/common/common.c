@@ -8,29 +8,62 @@
  * This file implements all function used by supervisor AND generator
  **/
 
+#include <ctype.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include "common.h"
+#include "ring.h"
 
-circular_buffer_t *memory_create(void) {
+static void memory_name(const char *instance, char *name);
+
+static bool memory_stale(const char *name);
+
+circular_buffer_t *memory_create(const char *instance, size_t max_edges, unsigned int capacity, uint64_t seed,
+                                 unsigned int hubs) {
     circular_buffer_t *shared;
+    char name[NAME_SIZE];
 
-    /* create and/or open shared memory object */
-    int shmfd = shm_open(SHM_NAME, O_RDWR | O_CREAT, PERMISSION);
+    memory_name(instance, name);
+
+    // Round up, so every slot starts on a cache line like the first one
+    size_t slot_size = sizeof(slot_t) + sizeof(edge_t) * max_edges;
+    slot_size = (slot_size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    size_t size = sizeof(circular_buffer_t) + slot_size * capacity;
+
+    /* create shared memory object, never take over the ring of a running supervisor */
+    int shmfd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, PERMISSION);
+    if (shmfd == -1 && errno == EEXIST && memory_stale(name)) {
+        // Left behind by a supervisor that was killed
+        if (shm_unlink(name) == -1 && errno != ENOENT) {
+            error_exit("Cannot unlink stale shared memory");
+        }
+        shmfd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, PERMISSION);
+    }
     if (shmfd == -1) {
+        if (errno == EEXIST) {
+            char reason[NAME_SIZE + 128];
+            snprintf(reason, sizeof(reason), "Shared memory already exists. Is another supervisor running on "
+                                             "this instance? If not, remove /dev/shm%s", name);
+            error_exit(reason);
+        }
         error_exit("Cannot create shared memory");
     }
 
     /* extend (set size) */
-    if (ftruncate(shmfd, sizeof *shared) == -1) {
+    if (ftruncate(shmfd, (off_t) size) == -1) {
         error_exit("Cannot truncate shared memory file");
     }
 
     /* map shared memory object */
-    shared = mmap(NULL, sizeof *shared, PROT_READ | PROT_WRITE, MAP_SHARED, shmfd, 0);
+    shared = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, shmfd, 0);
 
     if (shared == MAP_FAILED) {
         error_exit("Cannot map shared memory");
@@ -40,36 +73,82 @@ circular_buffer_t *memory_create(void) {
         error_exit("Cannot close shared memory file");
     }
 
+    shared->max_edges = max_edges;
+    shared->capacity = capacity;
+    shared->slot_size = slot_size;
+    shared->memory_size = size;
+    strcpy(shared->name, name);
+    shared->seed = seed;
+    shared->hubs = hubs;
+    shared->owner = getpid();
+
+    ring_init(shared);
+    atomic_init(&shared->best_size, max_edges + 1);
+    atomic_init(&shared->next_unit, 0);
+
+    // Generators may map the memory as soon as it has its size, so they wait for this
+    atomic_store_explicit(&shared->magic, MEMORY_MAGIC, memory_order_release);
+
     return shared;
 }
 
 void memory_destroy(circular_buffer_t *shared) {
+    char name[NAME_SIZE];
+
     if (shared == NULL) return;
+    strcpy(name, shared->name);
+
     /* unmap shared memory */
-    if (munmap(shared, sizeof *shared) == -1) {
+    if (munmap(shared, shared->memory_size) == -1) {
         fprintf(stderr, "Cannot unmap shared memory"); // Dont error_exit, since this is will be called with atexit
     }
 
     /* remove shared memory object */
-    if (shm_unlink(SHM_NAME) == -1) {
+    if (shm_unlink(name) == -1) {
         fprintf(stderr, "Cannot unlink shared memory"); // Dont error_exit, since this is will be called with atexit
     }
 }
 
-circular_buffer_t *memory_open(void) {
+circular_buffer_t *memory_open(const char *instance) {
     circular_buffer_t *shared;
+    char name[NAME_SIZE];
+
+    memory_name(instance, name);
 
     /* create and/or open shared memory object */
-    int shmfd = shm_open(SHM_NAME, O_RDWR, 0);
+    int shmfd = shm_open(name, O_RDWR, 0);
     if (shmfd == -1) {
         error_exit("Cannot open shared memory. Has the supervisor been started yet?");
     }
 
-    /* map shared memory object */
-    shared = mmap(NULL, sizeof *shared, PROT_READ | PROT_WRITE, MAP_SHARED, shmfd, 0);
+    /* the supervisor has chosen the size, but may still be setting up the memory */
+    for (int tries = 0;; tries++) {
+        struct timespec delay = {0, OPEN_DELAY_NS};
+        struct stat info;
 
-    if (shared == MAP_FAILED) {
-        error_exit("Cannot map shared memory");
+        if (fstat(shmfd, &info) == -1) {
+            error_exit("Cannot stat shared memory file");
+        }
+
+        // The size is set at once, so a large enough memory has its final size
+        if ((size_t) info.st_size >= sizeof *shared) {
+            /* map shared memory object */
+            shared = mmap(NULL, (size_t) info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, shmfd, 0);
+
+            if (shared == MAP_FAILED) {
+                error_exit("Cannot map shared memory");
+            }
+
+            if (atomic_load_explicit(&shared->magic, memory_order_acquire) == MEMORY_MAGIC) break;
+
+            munmap(shared, (size_t) info.st_size);
+        }
+
+        if (tries == OPEN_TRIES) {
+            error_exit("Shared memory has not been set up yet");
+        }
+
+        nanosleep(&delay, NULL);
     }
 
     if (close(shmfd) == -1) {
@@ -82,106 +161,85 @@ circular_buffer_t *memory_open(void) {
 void memory_close(circular_buffer_t *shared) {
     if (shared == NULL) return;
     /* unmap shared memory */
-    if (munmap(shared, sizeof *shared) == -1) {
+    if (munmap(shared, shared->memory_size) == -1) {
         fprintf(stderr, "Cannot unmap shared memory"); // Dont error_exit, since this is will be called with atexit
     }
 }
 
-semaphores_t *semaphores_create(void) {
-    semaphores_t *semaphores = malloc(sizeof(semaphores_t));
+void solution_init(solution_t *solution, size_t max_edges) {
+    solution->size = 0;
+    solution->edges = malloc(sizeof(edge_t) * max_edges);
 
-    if (semaphores == NULL) {
+    if (max_edges > 0 && solution->edges == NULL) {
         error_exit("Cannot allocate memory");
-        return NULL;
     }
-
-    if ((semaphores->free = sem_open(SEM_FREE, O_CREAT, PERMISSION, BUFFER_SIZE)) == SEM_FAILED) {
-        error_exit("Cannot create free semaphore");
-    }
-
-    if ((semaphores->used = sem_open(SEM_USED, O_CREAT, PERMISSION, 0)) == SEM_FAILED) {
-        error_exit("Cannot create used semaphore");
-    }
-
-    if ((semaphores->mutex = sem_open(SEM_MUTEX, O_CREAT, PERMISSION, 1)) == SEM_FAILED) {
-        error_exit("Cannot create mutex semaphore");
-    }
-
-    return semaphores;
 }
 
-void semaphores_destroy(semaphores_t *semaphores) {
-    if (semaphores == NULL) return;
-
-    if (sem_close(semaphores->free) < 0) {
-        fprintf(stderr, "Cannot close free semaphore"); // Dont error_exit, since this is will be called with atexit
-    }
-
-    if (sem_close(semaphores->used) < 0) {
-        fprintf(stderr, "Cannot close used semaphore"); // Dont error_exit, since this is will be called with atexit
-    }
-
-    if (sem_close(semaphores->mutex) < 0) {
-        fprintf(stderr, "Cannot close mutex semaphore"); // Dont error_exit, since this is will be called with atexit
-    }
-
-    if (sem_unlink(SEM_FREE) < 0) {
-        fprintf(stderr, "Cannot unlink free semaphore"); // Dont error_exit, since this is will be called with atexit
-    }
-
-    if (sem_unlink(SEM_USED) < 0) {
-        fprintf(stderr, "Cannot unlink used semaphore"); // Dont error_exit, since this is will be called with atexit
-    }
+void solution_copy(solution_t *destination, const solution_t *source) {
+    destination->size = source->size;
+    memcpy(destination->edges, source->edges, sizeof(edge_t) * source->size);
+}
 
-    if (sem_unlink(SEM_MUTEX) < 0) {
-        fprintf(stderr, "Cannot unlink mutex semaphore"); // Dont error_exit, since this is will be called with atexit
-    }
+void solution_free(solution_t *solution) {
+    free(solution->edges);
+}
 
-    free(semaphores);
+void error_exit(char *reason) {
+    fprintf(stderr, "An error occurred: %s\n", reason);
+    exit(EXIT_FAILURE);
 }
 
-semaphores_t *semaphores_open(void) {
-    semaphores_t *semaphores = malloc(sizeof(semaphores_t));
+/**
+ * @brief Checks whether existing shared memory was left behind by a supervisor that is gone
+ * @details Memory that is still being set up is never stale, since its owner is not known yet
+ * @param name The name of the shared memory
+ * @return True if the memory has been set up and its owner does not exist anymore
+ */
+static bool memory_stale(const char *name) {
+    bool stale = false;
 
-    if (semaphores == NULL) {
-        error_exit("Cannot allocate memory");
-        return NULL;
-    }
+    int shmfd = shm_open(name, O_RDONLY, 0);
+    if (shmfd == -1) return errno == ENOENT;
 
-    if ((semaphores->free = sem_open(SEM_FREE, 0)) == SEM_FAILED) {
-        error_exit("Cannot open free semaphore");
-    }
+    struct stat info;
+    if (fstat(shmfd, &info) == 0 && (size_t) info.st_size >= sizeof(circular_buffer_t)) {
+        circular_buffer_t *shared = mmap(NULL, sizeof(circular_buffer_t), PROT_READ, MAP_SHARED, shmfd, 0);
 
-    if ((semaphores->used = sem_open(SEM_USED, 0)) == SEM_FAILED) {
-        error_exit("Cannot open used semaphore");
+        if (shared != MAP_FAILED) {
+            if (atomic_load_explicit(&shared->magic, memory_order_acquire) == MEMORY_MAGIC) {
+                stale = kill(shared->owner, 0) == -1 && errno == ESRCH;
+            }
+            munmap(shared, sizeof(circular_buffer_t));
+        }
     }
 
-    if ((semaphores->mutex = sem_open(SEM_MUTEX, 1)) == SEM_FAILED) {
-        error_exit("Cannot open mutex semaphore");
-    }
+    close(shmfd);
 
-    return semaphores;
+    return stale;
 }
 
-void semaphores_close(semaphores_t *semaphores) {
-    if (semaphores == NULL) return;
+/**
+ * @brief Builds the name of the shared memory of an instance
+ * @details The name is SHM_NAME, followed by _ and the instance id if there is one.
+ *          Exits if the id is too long or contains characters other than letters, digits, - and _.
+ * @param instance The instance id, NULL for the one in INSTANCE_ENV
+ * @param name The name will be stored here, must have space for NAME_SIZE characters
+ */
+static void memory_name(const char *instance, char *name) {
+    if (instance == NULL) instance = getenv(INSTANCE_ENV);
 
-    if (sem_close(semaphores->free) < 0) {
-        fprintf(stderr, "Cannot close free semaphore"); // Dont error_exit, since this is will be called with atexit
+    if (instance == NULL || *instance == '\0') {
+        strcpy(name, SHM_NAME);
+        return;
     }
 
-    if (sem_close(semaphores->used) < 0) {
-        fprintf(stderr, "Cannot close used semaphore"); // Dont error_exit, since this is will be called with atexit
-    }
+    if (strlen(instance) > INSTANCE_MAX) error_exit("Instance id is too long");
 
-    if (sem_close(semaphores->mutex) < 0) {
-        fprintf(stderr, "Cannot close mutex semaphore"); // Dont error_exit, since this is will be called with atexit
+    for (const char *c = instance; *c != '\0'; c++) {
+        if (!isalnum((unsigned char) *c) && *c != '-' && *c != '_') {
+            error_exit("Instance id may only contain letters, digits, - and _");
+        }
     }
 
-    free(semaphores);
+    sprintf(name, "%s_%s", SHM_NAME, instance);
 }
-
-void error_exit(char *reason) {
-    fprintf(stderr, "An error occurred: %s\n", reason);
-    exit(EXIT_FAILURE);
-}
\ No newline at end of file
@@ -5,27 +5,33 @@
  *
  * @brief Common program module header.
  *
- * Defines a bunch of constants and the structures for semaphores and shared memory.
- * Also defines functions that either set up or interact with shm and sem.
+ * Defines a bunch of constants and the structures for shared memory.
+ * Also defines functions that set up the shm.
  **/
 
 
 #ifndef UE3_COMMON_H
 #define UE3_COMMON_H
 
-#include <semaphore.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
 
 #define SHM_NAME "/osue_3crl_shm" /**< Name of the shared memory **/
-#define PERMISSION (0600) /**< Create permissions for shared memory and semaphores **/
-
-// semaphores
-#define SEM_FREE "/osue_3clr_free" /**< Name of write semaphore */
-#define SEM_USED "/osue_3clr_used" /**< Name of read semaphore */
-#define SEM_MUTEX "/osue_3clr_mutex" /**< Name of mutex semaphore */
-
-#define SOLUTION_MAX_EDGES (8) /**< Maximal number of edges in a solution */
-#define BUFFER_SIZE (16) /** Buffer size */
+#define INSTANCE_ENV "OSUE_3CRL_INSTANCE" /**< Environment variable with the default instance **/
+#define INSTANCE_MAX (32) /**< Maximal length of an instance id **/
+#define NAME_SIZE (sizeof(SHM_NAME) + 1 + INSTANCE_MAX) /**< Size of a shared memory name with an instance id **/
+#define PERMISSION (0600) /**< Create permissions for shared memory **/
+
+#define SOLUTION_MAX_EDGES (8) /**< Default maximal number of edges in a solution */
+#define BUFFER_SIZE (16) /** Default buffer size, must be a power of two */
+#define CACHE_LINE (64) /** Size of a cache line, parts written by different processes are this far apart */
+#define HUBS_MAX (10) /** Maximal amount of vertices whose colors are fixed by a work unit */
+#define MEMORY_MAGIC (0x33636f6cu) /** Stored last when the shared memory has been set up */
+#define OPEN_TRIES (100) /** Times a generator checks whether the shared memory has been set up */
+#define OPEN_DELAY_NS (10000000L) /** Nanoseconds between two of these checks */
 
 /**
  * @struct Edge struct
@@ -44,40 +50,77 @@ typedef struct edge {
  */
 typedef struct solution {
     size_t size; /** Amount of vertices */
-    edge_t edges[SOLUTION_MAX_EDGES]; /** Vertices to remove */
+    edge_t *edges; /** Vertices to remove, space for max_edges of the shared memory */
 } solution_t;
 
+/**
+ * @struct Slot struct
+ * @brief A single entry of the circular buffer
+ * @details The sequence number tells producers and the consumer whether the slot is theirs.
+ *          Every slot has space for max_edges edges, so slots are slot_size bytes apart.
+ *          Typedef as slot_t
+ */
+typedef struct slot {
+    atomic_uint sequence; /** pos while the slot is free for position pos, pos + 1 once it has been written */
+    size_t size; /** Amount of edges of the stored solution */
+    edge_t edges[]; /** Edges of the stored solution */
+} slot_t;
+
 /**
  * @struct Shared memory struct
  * @brief Struct that contains all data that is communicated
- * @details Typedef as circular_buffer_t
+ * @details Positions only grow and wrap around, the slot is selected with a bitmask.
+ *          The fields are grouped by who writes them and every group starts on its own cache line, so producers
+ *          and the consumer do not invalidate each other's lines. Slots also start on a cache line.
+ *          Typedef as circular_buffer_t
  */
 typedef struct circular_buffer {
-    bool quit; /** Quit flag */
-    int readpos; /** The position to read from */
-    int writepos; /** To position to write to */
-    solution_t solutions[BUFFER_SIZE]; /** The solution array */
+    // Set up by the supervisor, read only afterwards
+    _Alignas(CACHE_LINE) atomic_uint magic; /** MEMORY_MAGIC once everything else has been set up */
+    pid_t owner; /** Process id of the supervisor, the memory is stale once it is gone */
+    size_t max_edges; /** Maximal number of edges in a solution */
+    unsigned int capacity; /** Amount of slots, a power of two */
+    size_t slot_size; /** Distance between two slots in bytes */
+    size_t memory_size; /** Size of the whole shared memory in bytes */
+    char name[NAME_SIZE]; /** Name of the shared memory, needed to unlink it */
+    uint64_t seed; /** Random seed of this run, work unit i uses seed + i */
+    unsigned int hubs; /** Amount of highest degree vertices whose colors are fixed by the work unit */
+
+    // Rarely written
+    _Alignas(CACHE_LINE) atomic_bool quit; /** Quit flag */
+    atomic_size_t best_size; /** Size of the best solution the supervisor has received so far */
+    atomic_uint next_unit; /** Next work unit to hand out to a generator thread */
+
+    // Written by the producers
+    _Alignas(CACHE_LINE) atomic_uint writepos; /** To position to write to */
+    atomic_uint published; /** Futex word, incremented after every write */
+    atomic_uint producers_waiting; /** Amount of producers waiting on consumed */
+
+    // Written by the consumer
+    _Alignas(CACHE_LINE) atomic_uint readpos; /** The position to read from */
+    atomic_uint consumed; /** Futex word, incremented after every read */
+    atomic_uint consumer_waiting; /** Amount of consumers waiting on published */
+
+    _Alignas(CACHE_LINE) unsigned char slots[]; /** The solution slots */
 } circular_buffer_t;
 
-/**
- * @struct Semaphore struct
- * @brief Strcut that maps the used semaphores together
- * @brief Typedef as auth_semaphore_t
- */
-typedef struct semaphores {
-    sem_t *mutex; /**< mutex semaphore */
-    sem_t *free; /**< free semaphore */
-    sem_t *used; /**< used semaphore */
-} semaphores_t;
-
 /**
  * Creates and maps the shared memory used in this program
  *
  * @brief Creates shared memory at SHM_NAME and with permissions PERMISSION
- * @details This function will generate an error if the shared memory was already created
+ * @details The memory is sized for capacity solutions of up to max_edges edges. The ring in the memory is
+ *          initialized with ring_init. Supervisors and generators of different instances use different memory.
+ *          Exits if the memory of the instance already exists, so a second supervisor cannot reset the ring,
+ *          unless the supervisor that created it is gone. Then the stale memory is removed first.
+ * @param instance The instance id, NULL for the one in INSTANCE_ENV or none if that is not set either
+ * @param max_edges Maximal number of edges in a solution
+ * @param capacity Amount of slots of the ring, must be a power of two
+ * @param seed Random seed of the run
+ * @param hubs Amount of highest degree vertices whose colors are fixed by the work unit
  * @return The creates shared memory
  */
-circular_buffer_t *memory_create(void);
+circular_buffer_t *memory_create(const char *instance, size_t max_edges, unsigned int capacity, uint64_t seed,
+                                 unsigned int hubs);
 
 /**
  * Unlinks and destroys the shared memory used in this program
@@ -91,9 +134,12 @@ void memory_destroy(circular_buffer_t *shared);
  * Opens existing shared memory instance
  *
  * @brief Opens existing shared memory. The memory must have been created before of this function will error
+ * @details Maps the size that the creator has chosen. Waits up to OPEN_TRIES times OPEN_DELAY_NS for the
+ *          creator to finish setting the memory up and exits if it does not.
+ * @param instance The instance id, NULL for the one in INSTANCE_ENV or none if that is not set either
  * @return The opened memory
  */
-circular_buffer_t *memory_open(void);
+circular_buffer_t *memory_open(const char *instance);
 
 /**
  * Closes an open shared memory instance
@@ -104,43 +150,35 @@ circular_buffer_t *memory_open(void);
 void memory_close(circular_buffer_t *shared);
 
 /**
- * @brief DEBUG: Prints the content of the given shared memory object
- * @param shared The memory to print
- */
-void print_memory(circular_buffer_t *shared);
-
-/**
- * Creates an instance of auth_semaphores_t containing the required semaphores
+ * Allocates a solution
  *
- * @brief Creates an instance of auth_semaphores_t and sets up the semaphore links for server, client and mutex
- * @details This function will error if the semaphores were already created
- * @return A pointer to the allocated structure
+ * @brief Allocates space for the edges of a solution
+ * @param solution The solution, which will be empty
+ * @param max_edges Maximal number of edges in the solution
  */
-semaphores_t *semaphores_create(void);
+void solution_init(solution_t *solution, size_t max_edges);
 
 /**
- * Destroys the used semaphores
+ * Copies a solution
  *
- * @brief Unlinks and destroys the semaphores, then frees the container
- * @param semaphores The semaphores to destroy
+ * @brief Copies the size and the edges of a solution into the space of another one
+ * @param destination The solution to copy to, must have space for the edges of source
+ * @param source The solution to copy
  */
-void semaphores_destroy(semaphores_t *semaphores);
+void solution_copy(solution_t *destination, const solution_t *source);
 
 /**
- * Opens the existing semaphores and maps them together
+ * Frees a solution
  *
- * @brief The semaphores to open must have been created before
- * @return The opened semaphores
+ * @param solution The solution to free
  */
-semaphores_t *semaphores_open(void);
+void solution_free(solution_t *solution);
 
 /**
- * Closes the opened semaphores
- *
- * @brief Closes the opened semaphores, but does not destroy them
- * @param semaphores The semaphores to close
+ * @brief DEBUG: Prints the content of the given shared memory object
+ * @param shared The memory to print
  */
-void semaphores_close(semaphores_t *semaphores);
+void print_memory(circular_buffer_t *shared);
 
 /**
  * @brief Prints the given reason to stderr and exits with EXIT_FAILURE
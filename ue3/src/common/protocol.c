@@ -0,0 +1,40 @@
+/**
+ * @file protocol.c
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Socket protocol module.
+ *
+ * Reads and writes whole messages on stream sockets.
+ **/
+
+#include <sys/socket.h>
+#include "protocol.h"
+
+bool protocol_read(int fd, void *data, size_t size) {
+    unsigned char *p = data;
+
+    while (size > 0) {
+        ssize_t count = recv(fd, p, size, 0);
+        if (count <= 0) return false;
+
+        p += count;
+        size -= (size_t) count;
+    }
+
+    return true;
+}
+
+bool protocol_write(int fd, const void *data, size_t size) {
+    const unsigned char *p = data;
+
+    while (size > 0) {
+        ssize_t count = send(fd, p, size, MSG_NOSIGNAL);
+        if (count <= 0) return false;
+
+        p += count;
+        size -= (size_t) count;
+    }
+
+    return true;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file protocol.h
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Socket protocol header.
+ *
+ * Defines the messages between the supervisor and generators that attach through a Unix domain socket instead
+ * of the shared memory. After accepting, the supervisor sends a hello_t. Then the generator sends messages,
+ * each answered by the supervisor with a single uint64_t:
+ * - MESSAGE_UNIT claims a work unit, the answer is its number
+ * - MESSAGE_SOLUTION is followed by size edges, the answer is the size of the best solution so far
+ * The supervisor closes the connection when it shuts down.
+ **/
+
+#ifndef UE3_PROTOCOL_H
+#define UE3_PROTOCOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "common.h"
+
+#define MESSAGE_UNIT (1) /** Claims a work unit */
+#define MESSAGE_SOLUTION (2) /** Publishes a solution */
+
+/**
+ * @struct Hello struct
+ * @brief Parameters of the run, sent to every generator that connects
+ * @details Typedef as hello_t
+ */
+typedef struct hello {
+    uint64_t max_edges; /** Maximal number of edges in a solution */
+    uint64_t seed; /** Random seed of this run */
+    uint32_t hubs; /** Amount of highest degree vertices whose colors are fixed by the work unit */
+    uint32_t reserved; /** Padding, always 0 */
+} hello_t;
+
+/**
+ * @struct Message struct
+ * @brief Header of a message from a generator
+ * @details Typedef as message_t
+ */
+typedef struct message {
+    uint32_t type; /** MESSAGE_UNIT or MESSAGE_SOLUTION */
+    uint32_t size; /** Amount of edges that follow */
+} message_t;
+
+/**
+ * Reads from a socket
+ *
+ * @brief Reads exactly size bytes, continuing after short reads
+ * @param fd The socket
+ * @param data The read bytes will be stored here
+ * @param size The amount of bytes
+ * @return False if the connection was closed or the read failed or was interrupted
+ */
+bool protocol_read(int fd, void *data, size_t size);
+
+/**
+ * Writes to a socket
+ *
+ * @brief Writes exactly size bytes, continuing after short writes
+ * @details Does not raise SIGPIPE if the other side has closed the connection
+ * @param fd The socket
+ * @param data The bytes to write
+ * @param size The amount of bytes
+ * @return False if the connection was closed or the write failed or was interrupted
+ */
+bool protocol_write(int fd, const void *data, size_t size);
+
+#endif //UE3_PROTOCOL_H
@@ -0,0 +1,200 @@
+/**
+ * @file ring.c
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Lock-free ring buffer module.
+ *
+ * Bounded multi-producer queue with a sequence number per slot. Producers claim a position with a CAS on
+ * writepos and publish the slot by advancing its sequence number, so no lock is needed. Waiting processes
+ * sleep on futex words in the shared memory, which are only touched if somebody actually waits.
+ **/
+
+#include <errno.h>
+#include <limits.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#include "ring.h"
+
+static slot_t *slot_at(circular_buffer_t *buffer, unsigned int pos);
+
+static bool futex_wait(atomic_uint *word, unsigned int value);
+
+static void futex_wake(atomic_uint *word, int count);
+
+static bool wait_slot(circular_buffer_t *buffer, atomic_uint *word, atomic_uint *waiting, slot_t *slot,
+                      unsigned int ready);
+
+static const atomic_bool *cancel = NULL; /** Quit flag of this process, see ring_cancel */
+
+void ring_init(circular_buffer_t *buffer) {
+    atomic_init(&buffer->quit, false);
+    atomic_init(&buffer->readpos, 0);
+    atomic_init(&buffer->writepos, 0);
+    atomic_init(&buffer->published, 0);
+    atomic_init(&buffer->consumed, 0);
+    atomic_init(&buffer->consumer_waiting, 0);
+    atomic_init(&buffer->producers_waiting, 0);
+
+    for (unsigned int i = 0; i < buffer->capacity; i++) {
+        atomic_init(&slot_at(buffer, i)->sequence, i);
+    }
+}
+
+bool ring_push(circular_buffer_t *buffer, const solution_t *solution) {
+    unsigned int pos = atomic_load_explicit(&buffer->writepos, memory_order_relaxed);
+    slot_t *slot;
+
+    for (;;) {
+        slot = slot_at(buffer, pos);
+        int diff = (int) (atomic_load_explicit(&slot->sequence, memory_order_acquire) - pos);
+
+        if (diff == 0) {
+            // The slot is free, try to claim it. On failure pos is updated to the current writepos.
+            if (atomic_compare_exchange_weak_explicit(&buffer->writepos, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The slot still holds the solution of the previous round, so the ring is full
+            if (!wait_slot(buffer, &buffer->consumed, &buffer->producers_waiting, slot, pos)) return false;
+            pos = atomic_load_explicit(&buffer->writepos, memory_order_relaxed);
+        } else {
+            // Another producer claimed this position in the meantime
+            pos = atomic_load_explicit(&buffer->writepos, memory_order_relaxed);
+        }
+    }
+
+    slot->size = solution->size;
+    memcpy(slot->edges, solution->edges, sizeof(edge_t) * solution->size);
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+
+    atomic_fetch_add(&buffer->published, 1);
+    if (atomic_load(&buffer->consumer_waiting) > 0) futex_wake(&buffer->published, 1);
+
+    return true;
+}
+
+bool ring_pop(circular_buffer_t *buffer, solution_t *solution) {
+    unsigned int pos = atomic_load_explicit(&buffer->readpos, memory_order_relaxed);
+    slot_t *slot = slot_at(buffer, pos);
+
+    // Wait until the producer of this position has published it
+    while ((int) (atomic_load_explicit(&slot->sequence, memory_order_acquire) - (pos + 1)) < 0) {
+        if (!wait_slot(buffer, &buffer->published, &buffer->consumer_waiting, slot, pos + 1)) return false;
+    }
+
+    solution->size = slot->size;
+    memcpy(solution->edges, slot->edges, sizeof(edge_t) * slot->size);
+
+    // Hand the slot over to the producers of the next round
+    atomic_store_explicit(&buffer->readpos, pos + 1, memory_order_relaxed);
+    atomic_store_explicit(&slot->sequence, pos + buffer->capacity, memory_order_release);
+
+    atomic_fetch_add(&buffer->consumed, 1);
+    if (atomic_load(&buffer->producers_waiting) > 0) futex_wake(&buffer->consumed, INT_MAX);
+
+    return true;
+}
+
+void ring_cancel(const atomic_bool *flag) {
+    cancel = flag;
+}
+
+void ring_shutdown(circular_buffer_t *buffer) {
+    atomic_store(&buffer->quit, true);
+
+    atomic_fetch_add(&buffer->published, 1);
+    atomic_fetch_add(&buffer->consumed, 1);
+    futex_wake(&buffer->published, INT_MAX);
+    futex_wake(&buffer->consumed, INT_MAX);
+}
+
+/**
+ * @brief Finds the slot of a position
+ * @details Slots have a size that is only known at runtime, so they cannot be indexed like an array
+ * @param buffer The ring
+ * @param pos The position
+ * @return The slot
+ */
+static slot_t *slot_at(circular_buffer_t *buffer, unsigned int pos) {
+    // dont use mod but bitmask. this avoids issues with overflows of the counter
+    return (slot_t *) (buffer->slots + (pos & (buffer->capacity - 1)) * buffer->slot_size);
+}
+
+/**
+ * @brief Sleeps until word is woken up, if it still holds value, but at most RING_WAIT_NS
+ * @details Uses a shared futex, because the word is mapped by several processes.
+ *          Only yields the processor on systems without futexes.
+ * @param word The word to wait on
+ * @param value The expected value of word
+ * @return False if the wait was interrupted by a signal
+ */
+static bool futex_wait(atomic_uint *word, unsigned int value) {
+#ifdef __linux__
+    struct timespec timeout = {0, RING_WAIT_NS};
+
+    if (syscall(SYS_futex, (unsigned int *) word, FUTEX_WAIT, value, &timeout, NULL, 0) == -1) {
+        // EAGAIN means the value has already changed, the caller checks again after a timeout
+        if (errno == EINTR) return false;
+        if (errno != EAGAIN && errno != ETIMEDOUT) error_exit("Futex wait failed");
+    }
+#else
+    (void) word;
+    (void) value;
+    sched_yield();
+#endif
+    return true;
+}
+
+/**
+ * @brief Wakes up to count processes sleeping on word
+ * @param word The word to wake
+ * @param count The maximal amount of processes to wake
+ */
+static void futex_wake(atomic_uint *word, int count) {
+#ifdef __linux__
+    if (syscall(SYS_futex, (unsigned int *) word, FUTEX_WAKE, count, NULL, NULL, 0) == -1) {
+        error_exit("Futex wake failed");
+    }
+#else
+    (void) word;
+    (void) count;
+#endif
+}
+
+/**
+ * @brief Waits until word changes, unless ready becomes true first
+ * @details The waiter is announced in waiting before word is read. The other side increments word before it
+ *          checks waiting, so a wakeup cannot get lost between the check of the slot and the futex wait.
+ * @param buffer The ring
+ * @param word The futex word to wait on
+ * @param waiting The counter of waiting processes
+ * @param slot The slot to check
+ * @param ready The sequence number at which the slot is ready
+ * @return False if the wait was interrupted by a signal or the quit flag of this process, or the ring was shut down
+ */
+static bool wait_slot(circular_buffer_t *buffer, atomic_uint *word, atomic_uint *waiting, slot_t *slot,
+                      unsigned int ready) {
+    bool result = true;
+
+    atomic_fetch_add(waiting, 1);
+
+    unsigned int value = atomic_load(word);
+
+    if (atomic_load(&buffer->quit) || (cancel != NULL && atomic_load(cancel))) {
+        result = false;
+    } else if ((int) (atomic_load_explicit(&slot->sequence, memory_order_acquire) - ready) < 0) {
+        result = futex_wait(word, value);
+    }
+
+    atomic_fetch_sub(waiting, 1);
+
+    return result;
+}
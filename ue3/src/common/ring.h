@@ -0,0 +1,73 @@
+/**
+ * @file ring.h
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Lock-free ring buffer header.
+ *
+ * Declares the operations on the circular buffer in shared memory. Generators push solutions concurrently,
+ * the supervisor is the only one to pop them. Processes only block in a futex if the ring is full or empty.
+ **/
+
+#ifndef UE3_RING_H
+#define UE3_RING_H
+
+#include <stdbool.h>
+#include "common.h"
+
+#define RING_WAIT_NS (100000000L) /** Longest single futex wait, so a process notices its own quit flag */
+
+/**
+ * Initializes the ring
+ *
+ * @brief Resets positions, flags and the sequence numbers of all slots
+ * @details Must be called once by the creator of the shared memory before any generator attaches,
+ *          after capacity and slot_size have been set
+ * @param buffer The ring to initialize
+ */
+void ring_init(circular_buffer_t *buffer);
+
+/**
+ * Pushes a solution into the ring
+ *
+ * @brief Claims the next slot, copies the solution and publishes it to the supervisor
+ * @details Safe to be called by many processes at once. Blocks while the ring is full.
+ *          The solution must not have more than max_edges edges.
+ * @param buffer The ring to push to
+ * @param solution The solution to push
+ * @return True if the solution was pushed, false if the wait was interrupted by a signal or the quit flag of
+ *         this process, or the ring was shut down
+ */
+bool ring_push(circular_buffer_t *buffer, const solution_t *solution);
+
+/**
+ * Pops a solution from the ring
+ *
+ * @brief Takes the oldest published solution out of the ring
+ * @details Must only be called by a single process. Blocks while the ring is empty.
+ * @param buffer The ring to pop from
+ * @param solution The popped solution will be stored here, needs space for max_edges edges
+ * @return True if a solution was popped, false if the wait was interrupted by a signal or the quit flag of
+ *         this process, or the ring was shut down
+ */
+bool ring_pop(circular_buffer_t *buffer, solution_t *solution);
+
+/**
+ * Sets the quit flag of this process
+ *
+ * @brief Makes waits on the ring of this process give up once flag is set
+ * @details A signal that sets the flag just before a wait starts does not interrupt the wait. Waits are split
+ *          into parts of RING_WAIT_NS and check the flag between them, so they give up in bounded time.
+ * @param flag The flag, NULL for none
+ */
+void ring_cancel(const atomic_bool *flag);
+
+/**
+ * Shuts the ring down
+ *
+ * @brief Sets the quit flag and wakes every process that waits on the ring
+ * @param buffer The ring to shut down
+ */
+void ring_shutdown(circular_buffer_t *buffer);
+
+#endif //UE3_RING_H
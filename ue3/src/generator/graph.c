@@ -0,0 +1,175 @@
+/**
+ * @file graph.c
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Graph module.
+ *
+ * Builds the vertex indices and the adjacency array of a graph from its edges.
+ **/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "graph.h"
+
+static void index_vertices(graph_t *graph);
+
+static void build_adjacency(graph_t *graph);
+
+graph_t *graph_create(edge_t *edges, size_t edgec) {
+    graph_t *graph = malloc(sizeof(graph_t));
+    if (graph == NULL) error_exit("Cannot allocate memory");
+
+    graph->edges = edges;
+    graph->edgec = edgec;
+
+    index_vertices(graph);
+    build_adjacency(graph);
+
+    return graph;
+}
+
+void graph_free(graph_t *graph) {
+    free(graph->edges);
+    free(graph->indexed);
+    free(graph->vertices);
+    free(graph->offsets);
+    free(graph->neighbours);
+    free(graph);
+}
+
+size_t graph_hubs(const graph_t *graph, size_t count, int *hubs) {
+    size_t found = 0;
+
+    if (count > graph->vertc) count = graph->vertc;
+
+    // Insertion into the sorted selection, count is small
+    for (size_t i = 0; i < graph->vertc; i++) {
+        size_t degree = graph->offsets[i + 1] - graph->offsets[i], pos = found;
+
+        while (pos > 0 && graph->offsets[hubs[pos - 1] + 1] - graph->offsets[hubs[pos - 1]] < degree) pos--;
+        if (pos == count) continue;
+
+        if (found < count) found++;
+        memmove(&hubs[pos + 1], &hubs[pos], sizeof(int) * (found - 1 - pos));
+        hubs[pos] = (int) i;
+    }
+
+    return found;
+}
+
+/**
+ * @brief Gives every distinct vertex an index and translates the edges to indices
+ * @details The table maps a vertex value to its index, or -1 if it has not been seen yet. If the largest value is
+ *          small compared to the amount of edges, the value itself is the position in the table. Otherwise it
+ *          is an open addressing hash table with at most half of the entries in use.
+ * @param graph The graph with edges
+ */
+static void index_vertices(graph_t *graph) {
+    size_t edgec = graph->edgec, vertc = 0;
+    int max = 0;
+
+    for (size_t i = 0; i < edgec; i++) {
+        if (graph->edges[i].u > max) max = graph->edges[i].u;
+        if (graph->edges[i].v > max) max = graph->edges[i].v;
+    }
+
+    bool direct = (size_t) max < DIRECT_INDEX_FACTOR * edgec;
+    size_t capacity = 1;
+
+    if (direct) {
+        capacity = (size_t) max + 1;
+    } else {
+        // There are at max 2 * edges vertices
+        while (capacity < 4 * edgec) capacity *= 2;
+    }
+
+    int *values = malloc(sizeof(int) * capacity);
+    int *indices = malloc(sizeof(int) * capacity);
+    int *vertices = malloc(sizeof(int) * 2 * edgec);
+    edge_t *indexed = malloc(sizeof(edge_t) * edgec);
+    if (values == NULL || indices == NULL || vertices == NULL || indexed == NULL) {
+        error_exit("Cannot allocate memory");
+    }
+
+    memset(indices, -1, sizeof(int) * capacity);
+
+    for (size_t i = 0; i < 2 * edgec; i++) {
+        int vertex = i % 2 == 0 ? graph->edges[i / 2].u : graph->edges[i / 2].v;
+        size_t pos = (size_t) vertex;
+
+        if (!direct) {
+            // Fibonacci hashing, then linear probing
+            pos = (size_t) (((uint64_t) vertex * 0x9e3779b97f4a7c15ULL) >> 32) & (capacity - 1);
+            while (indices[pos] != -1 && values[pos] != vertex) {
+                pos = (pos + 1) & (capacity - 1);
+            }
+        }
+
+        if (indices[pos] == -1) {
+            values[pos] = vertex;
+            indices[pos] = (int) vertc;
+            vertices[vertc] = vertex;
+            vertc++;
+        }
+
+        if (i % 2 == 0) {
+            indexed[i / 2].u = indices[pos];
+        } else {
+            indexed[i / 2].v = indices[pos];
+        }
+    }
+
+    free(values);
+    free(indices);
+
+    graph->vertices = vertices;
+    graph->vertc = vertc;
+    graph->indexed = indexed;
+}
+
+/**
+ * @brief Builds the adjacency of the vertex indices from the indexed edges
+ * @details Counts the degrees first, so every vertex gets a contiguous range in a single array
+ * @param graph The graph with vertices and edges
+ */
+static void build_adjacency(graph_t *graph) {
+    size_t *offsets = calloc(graph->vertc + 1, sizeof(size_t));
+    int *neighbours = malloc(sizeof(int) * 2 * graph->edgec);
+    if (offsets == NULL || neighbours == NULL) error_exit("Cannot allocate memory");
+
+    graph->loopc = 0;
+
+    for (size_t i = 0; i < graph->edgec; i++) {
+        edge_t edge = graph->indexed[i];
+
+        if (edge.u == edge.v) {
+            graph->loopc++;
+        } else {
+            offsets[edge.u + 1]++;
+            offsets[edge.v + 1]++;
+        }
+    }
+
+    for (size_t i = 0; i < graph->vertc; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    // Use the offsets as insert positions and shift them back afterwards
+    for (size_t i = 0; i < graph->edgec; i++) {
+        edge_t edge = graph->indexed[i];
+        if (edge.u == edge.v) continue;
+
+        neighbours[offsets[edge.u]++] = edge.v;
+        neighbours[offsets[edge.v]++] = edge.u;
+    }
+
+    for (size_t i = graph->vertc; i > 0; i--) {
+        offsets[i] = offsets[i - 1];
+    }
+    offsets[0] = 0;
+
+    graph->offsets = offsets;
+    graph->neighbours = neighbours;
+}
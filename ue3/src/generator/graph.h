@@ -0,0 +1,68 @@
+/**
+ * @file graph.h
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Graph header.
+ *
+ * Defines the graph the generators search solutions for.
+ **/
+
+#ifndef UE3_GRAPH_H
+#define UE3_GRAPH_H
+
+#include <stddef.h>
+#include "../common/common.h"
+
+/**
+ * @struct Graph struct
+ * @brief Parsed data from a generator
+ * @details The neighbours of vertex index i are neighbours[offsets[i]] to neighbours[offsets[i + 1] - 1].
+ *          Loops are not part of the adjacency, they conflict with every coloring.
+ *          Typedef as graph_t
+ */
+typedef struct graph {
+    size_t vertc; /** vertex count */
+    size_t edgec; /** edge count */
+    size_t loopc; /** amount of edges from a vertex to itself */
+    int *vertices; /** vertices, the position of a vertex is its index */
+    edge_t *edges; /** edges with the original vertex values */
+    edge_t *indexed; /** edges with the indices of their vertices */
+    size_t *offsets; /** start of the neighbours of every vertex index, vertc + 1 entries */
+    int *neighbours; /** indices of the adjacent vertices */
+} graph_t;
+
+#define DIRECT_INDEX_FACTOR (8) /** Vertex values below this factor times the edge count are indexed directly */
+
+/**
+ * Creates a graph
+ *
+ * @brief Numbers the distinct vertices and builds the adjacency of the vertex indices
+ * @details Vertices get indices in the order of their first appearance. Needs time linear in the amount of
+ *          edges: small vertex values are looked up in a table indexed by the value, large ones in a hash table.
+ * @param edges The edges with the original vertex values, which must not be negative. The graph takes ownership.
+ * @param edgec The amount of edges
+ * @return The created graph
+ */
+graph_t *graph_create(edge_t *edges, size_t edgec);
+
+/**
+ * Finds the vertices with the highest degrees
+ *
+ * @brief Selects up to count vertex indices, ordered by decreasing degree and then by index
+ * @details The order only depends on the graph, so every generator of the same graph gets the same vertices
+ * @param graph The graph
+ * @param count The amount of vertices to select
+ * @param hubs The selected vertex indices will be stored here
+ * @return The amount of selected vertices, less than count if the graph is smaller
+ */
+size_t graph_hubs(const graph_t *graph, size_t count, int *hubs);
+
+/**
+ * Frees a graph
+ *
+ * @param graph The graph to free, including its edges
+ */
+void graph_free(graph_t *graph);
+
+#endif //UE3_GRAPH_H
@@ -0,0 +1,30 @@
+/**
+ * @file input.h
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Graph input header.
+ *
+ * Declares the reader for graphs that are too large to be passed as arguments.
+ **/
+
+#ifndef UE3_INPUT_H
+#define UE3_INPUT_H
+
+#include <stddef.h>
+#include "../common/common.h"
+
+/**
+ * Reads the edges of a graph
+ *
+ * @brief Reads an edge list or a DIMACS graph from a file or stdin
+ * @details Every line holds one edge, either as u-v, as u v or in DIMACS as e u v. Empty lines, DIMACS
+ *          comments (c ...) and problem lines (p edge V E) are skipped. Regular files are mapped instead of read.
+ *          Exits on invalid input.
+ * @param path The file to read, - for stdin
+ * @param edgec The amount of read edges will be stored here
+ * @return The edges, to be freed by the caller
+ */
+edge_t *input_read(const char *path, size_t *edgec);
+
+#endif //UE3_INPUT_H
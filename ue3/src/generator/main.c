@@ -9,6 +9,7 @@
  **/
 
 #include <signal.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <getopt.h>
@@ -16,14 +17,16 @@
 #include <memory.h>
 #include <time.h>
 #include <errno.h>
+#include <unistd.h>
 #include "main.h"
+#include "input.h"
+#include "transport.h"
+#include "../common/ring.h"
 
 static graph_t *parse_arguments(int argc, char *argv[]);
 
 static void usage(void);
 
-static void free_graph(graph_t *graph);
-
 static void create_signal_handler(void);
 
 static void handle_signal(int signal);
@@ -34,19 +37,31 @@ static void parse_edge(char *input, edge_t *edge);
 
 static int parse_int(char *string);
 
-static void add_vertex(int vertex, int *vertices, size_t *vertc);
+static void assign_unit(worker_t *worker);
+
+static bool hub_colors(unsigned int code, unsigned int *colors);
+
+static int generate_solution(worker_t *worker, solution_t *solution, size_t limit);
+
+static void random_coloring(rng_t *rng, coloring_t *coloring);
 
-static int generate_solution(graph_t *graph, solution_t *solution);
+static uint64_t same_color(coloring_t u, coloring_t v);
+
+static void *work(void *arg);
+
+static void start_worker(worker_t *worker);
 
 static char *pgm_name; /** Program name */
-static circular_buffer_t *buffer; /** Shared memory circular buffer */
-static semaphores_t *semaphores; /** Semaphores clustered together */
-volatile sig_atomic_t quit = 0; /** Quit flag */
+static transport_t transport; /** Connection to the supervisor */
+static char *socket_path = NULL; /** Socket of the supervisor, NULL to use the shared memory */
+static int hubs[HUBS_MAX]; /** Highest degree vertex indices, whose colors are fixed by the work unit */
+static size_t hubc = 0; /** Amount of vertices in hubs */
+static int thread_count = 1; /** Amount of worker threads */
+static char *instance = NULL; /** Instance id of the supervisor, NULL for the default one */
+static bool local_search = false; /** Whether to improve colorings by local search instead of drawing new ones */
+atomic_bool quit = false; /** Quit flag, set by the signal handler and by any worker */
 
 int main(int argc, char *argv[]) {
-    // Seed for rand operation
-    srand(time(NULL));
-
     // This also handles setting pgm_name
     graph_t *graph = parse_arguments(argc, argv);
 
@@ -55,103 +70,302 @@ int main(int argc, char *argv[]) {
     }
 
     create_signal_handler();
+    ring_cancel(&quit);
 
-    buffer = memory_open();
-    semaphores = semaphores_open();
+    transport_open(&transport, instance, socket_path);
 
-    while (!quit) {
-        solution_t solution;
+    hubc = graph_hubs(graph, transport.hubs, hubs);
 
-        // Find a valid solution
-        while (generate_solution(graph, &solution) < 0);
+    worker_t *workers = malloc(sizeof(worker_t) * thread_count);
+    if (workers == NULL) error_exit("Cannot allocate memory");
 
-        // wait if there is no space left
-        if (sem_wait(semaphores->free) == -1) {
-            // interrupted by system call?
-            if (errno == EINTR) continue;
-            error_exit("Semaphore wait failed");
-        }
-
-        // request synced write access
-        if (sem_wait(semaphores->mutex) == -1) {
-            // interrupted by system call?
-            if (errno == EINTR) continue;
-            error_exit("Semaphore wait failed");
-        }
+    for (int i = 0; i < thread_count; i++) {
+        workers[i].graph = graph;
+        assign_unit(&workers[i]);
+        workers[i].colorings = NULL;
+        solution_init(&workers[i].solution, transport.max_edges);
+        solution_init(&workers[i].best, transport.max_edges);
 
-        // Before writing, check if supervisor has already shut down
-        if (buffer->quit) {
-            quit = 1;
+        if (local_search) {
+            search_init(&workers[i].search, graph, &workers[i].rng);
+        } else {
+            workers[i].colorings = malloc(sizeof(coloring_t) * graph->vertc);
+            if (workers[i].colorings == NULL) error_exit("Cannot allocate memory");
         }
+    }
 
-        // dont use mod but bitmask. this avoids issues with overflows of the counter
-        buffer->solutions[buffer->writepos & (BUFFER_SIZE - 1)] = solution;
-        buffer->writepos++;
+    // The main thread is the first worker
+    for (int i = 1; i < thread_count; i++) {
+        start_worker(&workers[i]);
+    }
 
-        if (sem_post(semaphores->mutex) == -1) error_exit("Semaphore post failed");
+    work(&workers[0]);
 
-        // increment the count of the number of items
-        if (sem_post(semaphores->used) == -1) error_exit("Semaphore post failed");
+    for (int i = 1; i < thread_count; i++) {
+        // Interrupts threads that wait for space in the ring, so they notice the quit flag
+        pthread_kill(workers[i].thread, WAKE_SIGNAL);
+        if (pthread_join(workers[i].thread, NULL) != 0) error_exit("Cannot join thread");
     }
 
     printf("Generator is shutting down.\n");
 
-    free_graph(graph);
+    for (int i = 0; i < thread_count; i++) {
+        free(workers[i].colorings);
+        solution_free(&workers[i].solution);
+        solution_free(&workers[i].best);
+        if (local_search) search_free(&workers[i].search);
+    }
+
+    free(workers);
+    graph_free(graph);
 
     return EXIT_SUCCESS;
 }
 
+/**
+ * @brief Worker thread
+ * @details Generates batches of solutions and publishes the best one of each batch until quit is set.
+ *          All threads share the ring of the process.
+ * @param arg The worker_t of this thread
+ * @return NULL
+ */
+static void *work(void *arg) {
+    worker_t *worker = arg;
+    solution_t *best = &worker->best;
+    size_t max_edges = transport.max_edges;
+
+    while (!atomic_load(&quit)) {
+        size_t bound = transport_bound(&transport);
+
+        // Solutions that do not beat the one of the supervisor are not needed, so stop counting there
+        best->size = bound < max_edges + 1 ? bound : max_edges + 1;
+
+        // Keep only the best solution of a batch, a 3-coloring cannot be beaten
+        if (local_search) {
+            for (int i = 0; i < SEARCH_BATCH && best->size > 0; i++) {
+                if (search_step(&worker->search) && worker->search.conflicts < best->size) {
+                    search_solution(&worker->search, best);
+                }
+            }
+        } else {
+            for (int i = 0; i < PUBLISH_BATCH && best->size > 0; i += LANES) {
+                if (generate_solution(worker, &worker->solution, best->size) == 0) {
+                    // Swap the spaces instead of copying the edges
+                    solution_t swap = worker->best;
+                    worker->best = worker->solution;
+                    worker->solution = swap;
+                }
+            }
+        }
+
+        // The supervisor may have received a better solution during the batch.
+        // Only blocks if there is no space left; fails if interrupted or the supervisor has shut down
+        if (best->size < transport_bound(&transport)) {
+            transport_push(&transport, best);
+        }
+
+        // Most batches publish nothing, so check if the supervisor has already shut down
+        if (transport_quit(&transport)) {
+            atomic_store(&quit, true);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Starts a worker thread that does not receive SIGINT and SIGTERM
+ * @details The signals must reach the main thread. If a worker took them while the main thread waits for space
+ *          in the ring, nobody would interrupt the main thread and it would never stop the other workers.
+ * @param worker The worker to run
+ */
+static void start_worker(worker_t *worker) {
+    sigset_t signals, old;
+
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+
+    // The new thread inherits the mask
+    pthread_sigmask(SIG_BLOCK, &signals, &old);
+    int result = pthread_create(&worker->thread, NULL, work, worker);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (result != 0) error_exit("Cannot create thread");
+}
+
 /**
  * @brief Generate a solution for the input graph
- * @details Calculates colors for each vertex and revoces edges where both vertices have the same color
- * @param graph The graph to find a solution for
+ * @details Evaluates LANES random colorings at once and keeps the one with the fewest edges of the same color.
+ *          Every coloring has a bit-sliced conflict counter, which starts at 2^planes - limit, so a carry out of
+ *          the highest plane marks exactly the colorings that reached the limit. Stops as soon as all colorings
+ *          have reached it. The colors of the hubs are fixed by the work unit of the worker.
+ * @param worker The worker with the graph, the random number generator and space for the colorings
  * @param solution The solution
- * @return Result code; -1 if the found solution has too many edges
+ * @param limit The solution must have fewer edges, at most the maximal number of edges in a solution plus one
+ * @return Result code; -1 if all found solutions have too many edges
  */
-static int generate_solution(graph_t *graph, solution_t *solution) {
-    int *colors;
-    int max = -1;
-    int pos = 0;
+static int generate_solution(worker_t *worker, solution_t *solution, size_t limit) {
+    const graph_t *graph = worker->graph;
+    coloring_t *colorings = worker->colorings;
+    uint64_t counters[COUNTER_PLANES], full = 0;
+    int planes = 0;
 
-    memset(solution, 0, sizeof(solution_t));
+    // Nothing beats a 3-coloring
+    if (limit == 0) return -1;
 
-    for (int i = 0; i < graph->vertc; i++) {
-        int vertex = graph->vertices[i];
+    for (size_t i = 0; i < graph->vertc; i++) {
+        random_coloring(&worker->rng, &colorings[i]);
+    }
 
-        if (vertex > max) {
-            max = vertex;
-        }
+    for (size_t i = 0; i < hubc; i++) {
+        colorings[hubs[i]] = worker->fixed[i];
+    }
+
+    while (((size_t) 1 << planes) < limit) planes++;
+    size_t offset = ((size_t) 1 << planes) - limit;
+
+    for (int k = 0; k < planes; k++) {
+        counters[k] = (offset >> k & 1) ? UINT64_MAX : 0;
     }
 
-    colors = malloc(sizeof(int) * (max + 1));
+    for (size_t i = 0; i < graph->edgec; i++) {
+        edge_t edge = graph->indexed[i];
+        uint64_t carry = same_color(colorings[edge.u], colorings[edge.v]);
 
-    if (colors == NULL) {
-        error_exit("Cannot allocate memory");
+        // Ripple carry adder, one bit per coloring
+        for (int k = 0; k < planes && carry != 0; k++) {
+            uint64_t sum = counters[k] ^ carry;
+            carry &= counters[k];
+            counters[k] = sum;
+        }
+
+        full |= carry;
+        if (full == UINT64_MAX) return -1;
     }
 
-    for (int i = 0; i < graph->vertc; i++) {
-        int vertex = graph->vertices[i];
-        colors[vertex] = rand() % 3; // 0, 1 or 2 are the 3 colors
+    int lane = 0;
+    size_t size = limit;
+
+    for (int i = 0; i < LANES; i++) {
+        if (full >> i & 1) continue;
+
+        size_t value = 0;
+        for (int k = 0; k < planes; k++) {
+            value |= (size_t) (counters[k] >> i & 1) << k;
+        }
+
+        if (value - offset < size) {
+            size = value - offset;
+            lane = i;
+        }
     }
 
-    for (int i = 0; i < graph->edgec; i++) {
-        // Only need solutions with less than 9 edges
-        if (pos == SOLUTION_MAX_EDGES) return -1;
-        edge_t edge = graph->edges[i];
-        // If vertices of solution have the same color, add to solution
-        if (colors[edge.u] == colors[edge.v]) {
-            solution->edges[pos] = edge;
+    // Collect the edges of the chosen coloring where both vertices have the same color
+    size_t pos = 0;
+
+    for (size_t i = 0; i < graph->edgec && pos < size; i++) {
+        edge_t edge = graph->indexed[i];
+
+        if (same_color(colorings[edge.u], colorings[edge.v]) >> lane & 1) {
+            solution->edges[pos] = graph->edges[i];
             pos++;
         }
     }
 
-    solution->size = (size_t) pos;
-
-    if (colors != NULL) free(colors);
+    solution->size = pos;
 
     return 0;
 }
 
+/**
+ * @brief Claims a work unit from the supervisor and prepares the worker for it
+ * @details Unit i seeds the random number generator with the seed of the run plus i, so no two threads of any
+ *          generator draw the same sequence. The colors of the hubs are the (i mod parts)-th canonical hub
+ *          coloring, see hub_colors, so units that differ in the lowest parts values search disjoint parts
+ *          of the colorings. Hub 0 always gets color 0 and hub 1 color 0 or 1. Local search only uses the seed,
+ *          fixed colors would only restrict it.
+ * @param worker The worker
+ */
+static void assign_unit(worker_t *worker) {
+    unsigned int unit = transport_unit(&transport), colors[HUBS_MAX], codes = 1, parts = 0, code;
+
+    rng_seed(&worker->rng, transport.seed + unit);
+
+    for (size_t i = 0; i < hubc; i++) {
+        codes *= 3;
+    }
+
+    for (code = 0; code < codes; code++) {
+        if (hub_colors(code, colors)) parts++;
+    }
+
+    unsigned int part = unit % parts;
+
+    // Leaves the colors of the chosen part in colors
+    for (code = 0;; code++) {
+        if (hub_colors(code, colors) && part-- == 0) break;
+    }
+
+    for (size_t i = 0; i < hubc; i++) {
+        worker->fixed[i].low = colors[i] & 1 ? UINT64_MAX : 0;
+        worker->fixed[i].high = colors[i] & 2 ? UINT64_MAX : 0;
+    }
+}
+
+/**
+ * @brief Decodes a coloring of the hubs and checks whether it is canonical
+ * @details The digits of code in base 3 are the colors of the hubs. Renaming the colors turns a coloring into
+ *          one with the same conflicts, so of all hub colorings that only differ by the names of the colors,
+ *          only the canonical one is searched: every hub uses at most the highest color of the hubs before it
+ *          plus one. With 3^hubc codes, that leaves 1, 1, 2, 5, 14, ... parts.
+ * @param code The hub coloring in base 3
+ * @param colors The colors of the hubs will be stored here
+ * @return Whether the coloring is canonical
+ */
+static bool hub_colors(unsigned int code, unsigned int *colors) {
+    unsigned int next = 0;
+
+    for (size_t i = 0; i < hubc; i++) {
+        colors[i] = code % 3;
+        code /= 3;
+
+        if (colors[i] > next) return false;
+        if (colors[i] == next) next++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Colors a vertex randomly in all colorings
+ * @details Draws two random bits per coloring and draws again for the colorings that got the invalid 11,
+ *          so 0, 1 and 2 are equally likely
+ * @param rng The random number generator of the calling thread
+ * @param coloring The colorings of the vertex
+ */
+static void random_coloring(rng_t *rng, coloring_t *coloring) {
+    uint64_t low = rng_next(rng), high = rng_next(rng), invalid;
+
+    while ((invalid = low & high) != 0) {
+        low = (low & ~invalid) | (rng_next(rng) & invalid);
+        high = (high & ~invalid) | (rng_next(rng) & invalid);
+    }
+
+    coloring->low = low;
+    coloring->high = high;
+}
+
+/**
+ * @brief Compares the colors of two vertices in all colorings
+ * @param u The colorings of the first vertex
+ * @param v The colorings of the second vertex
+ * @return A bit for every coloring, set if both vertices have the same color
+ */
+static uint64_t same_color(coloring_t u, coloring_t v) {
+    return ~((u.low ^ v.low) | (u.high ^ v.high));
+}
+
 /**
  * @brief Takes the argument vector and parses the positional arguments and options
  * @details Creates a graph instance from the given input
@@ -163,32 +377,54 @@ static int generate_solution(graph_t *graph, solution_t *solution) {
 static graph_t *parse_arguments(int argc, char *argv[]) {
     pgm_name = argv[0];
 
+    char *end, *path = NULL;
+    int c;
+    while ((c = getopt(argc, argv, "f:i:st:u:")) != -1) {
+        switch (c) {
+            case 'f':
+                path = optarg;
+                break;
+            case 'i':
+                instance = optarg;
+                break;
+            case 's':
+                local_search = true;
+                break;
+            case 't':
+                thread_count = (int) strtol(optarg, &end, 10);
+                if (*end != '\0' || thread_count < 1) usage();
+                break;
+            case 'u':
+                socket_path = optarg;
+                break;
+            default:
+                usage();
+        }
+    }
+
     int posc = argc - optind;
 
+    if (path != NULL) {
+        // Edges come either from the file or from the arguments
+        if (posc != 0) usage();
+
+        size_t edgec;
+        edge_t *edges = input_read(path, &edgec);
+
+        return graph_create(edges, edgec);
+    }
+
     // Check whether there was at least one edge specified
     if (posc == 0) usage();
 
-    size_t vertc = 0, edgec = (size_t) posc;
     edge_t *edges = malloc(sizeof(edge_t) * posc);
-    int *vertices = malloc(sizeof(int) * 2 * posc); // there are at max 2 * edges vertices
-    graph_t *graph = malloc(sizeof(graph_t));
-    if (edges == NULL || vertices == NULL || graph == NULL) error_exit("Cannot allocate memory");
+    if (edges == NULL) error_exit("Cannot allocate memory");
 
     for (int i = 0; i < posc; i++) {
-        edge_t edge;
-        parse_edge(argv[optind + i], &edge);
-        edges[i] = edge;
-
-        add_vertex(edge.u, vertices, &vertc);
-        add_vertex(edge.v, vertices, &vertc);
+        parse_edge(argv[optind + i], &edges[i]);
     }
 
-    graph->vertices = vertices;
-    graph->edges = edges;
-    graph->vertc = vertc;
-    graph->edgec = edgec;
-
-    return graph;
+    return graph_create(edges, (size_t) posc);
 }
 
 /**
@@ -214,22 +450,6 @@ static void parse_edge(char *input, edge_t *edge) {
     edge->v = v;
 }
 
-/**
- * @brief Adds a vertex to the vertices array but checks for duplicates
- * @details Also increases the vertex counter
- * @param vertex The vertex to add
- * @param vertices The array
- * @param vertc The counter
- */
-static void add_vertex(int vertex, int *vertices, size_t *vertc) {
-    for (int i = 0; i < *vertc; i++) {
-        if (vertices[i] == vertex) return;
-    }
-
-    vertices[*vertc] = vertex;
-    *vertc = *vertc + 1;
-}
-
 /**
  * @brief Parses a number from a string
  * @details Uses strtol
@@ -249,16 +469,17 @@ static int parse_int(char *string) {
  * @details global variables: pgm_name
  */
 static void usage(void) {
-    fprintf(stderr, "SYNOPSIS\n\t%s EDGE1...\nEXAMPLE\n\t%s 0-1 0-2 0-3 1-2 1-3 2-3\n", pgm_name, pgm_name);
+    fprintf(stderr, "SYNOPSIS\n\t%s [-i instance | -u socket] [-s] [-t threads] EDGE1...\n"
+                    "\t%s [-i instance | -u socket] [-s] [-t threads] -f file\n"
+                    "\t-f\tRead the edges from file, - for stdin. One edge per line as u-v, u v or DIMACS e u v\n"
+                    "\t-i\tInstance id of the supervisor, defaults to $" INSTANCE_ENV "\n"
+                    "\t-s\tImprove colorings by local search\n"
+                    "\t-t\tAmount of worker threads, defaults to 1\n"
+                    "\t-u\tConnect to the supervisor through this Unix domain socket instead of shared memory\n"
+                    "EXAMPLE\n\t%s 0-1 0-2 0-3 1-2 1-3 2-3\n", pgm_name, pgm_name, pgm_name);
     exit(EXIT_FAILURE);
 }
 
-static void free_graph(graph_t *graph) {
-    free(graph->edges);
-    free(graph->vertices);
-    free(graph);
-}
-
 /**
  * The callback function for the signal handler.
  * Stops the main loop.
@@ -266,12 +487,12 @@ static void free_graph(graph_t *graph) {
  * @param signal The signal to handle
  */
 static void handle_signal(int signal) {
-    quit = 1;
+    atomic_store(&quit, true);
 }
 
 /**
  * @brief Sets up the signal handler
- * @details Handle signals SIGINT and SIGTERM
+ * @details Handle signals SIGINT and SIGTERM, and WAKE_SIGNAL, which the main thread sends to the workers
  */
 static void create_signal_handler(void) {
     struct sigaction sa;
@@ -280,6 +501,7 @@ static void create_signal_handler(void) {
     sa.sa_handler = handle_signal;
     sigaction(SIGINT, &sa, NULL);
     sigaction(SIGTERM, &sa, NULL);
+    sigaction(WAKE_SIGNAL, &sa, NULL);
 }
 
 /**
@@ -287,6 +509,5 @@ static void create_signal_handler(void) {
  * @brief should be called with atexit
  */
 static void clean_up(void) {
-    memory_close(buffer);
-    semaphores_close(semaphores);
+    transport_close(&transport);
 }
\ No newline at end of file
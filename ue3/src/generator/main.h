@@ -1,18 +1,43 @@
 #ifndef MAIN_H
 #define MAIN_H
 
+#include <pthread.h>
+#include <signal.h>
 #include "../common/common.h"
+#include "graph.h"
+#include "rng.h"
+#include "search.h"
+
+#define LANES (64) /** Amount of colorings evaluated at once, one per bit of a word */
+#define PUBLISH_BATCH (64 * LANES) /** Amount of colorings of which only the best solution is published */
+#define COUNTER_PLANES (32) /** Maximal amount of bits of the bit-sliced conflict counters */
+#define WAKE_SIGNAL (SIGUSR1) /** Interrupts workers that wait, they do not receive SIGINT and SIGTERM */
+
+/**
+ * @struct Coloring struct
+ * @brief Colors of a single vertex in LANES independent colorings
+ * @details Bit i of low and high is the color of the vertex in coloring i, one of 00, 01 and 10.
+ *          Typedef as coloring_t
+ */
+typedef struct coloring {
+    uint64_t low; /** Lower bit of the colors */
+    uint64_t high; /** Higher bit of the colors */
+} coloring_t;
 
 /**
- * @struct Graph struct
- * @brief Parsed data from a generator
- * @details Typedef as graph_t
+ * @struct Worker struct
+ * @brief State of a single generating thread
+ * @details Typedef as worker_t
  */
-typedef struct graph {
-    size_t vertc; /** vertex count */
-    size_t edgec; /** edge count */
-    int *vertices; /** vertices */
-    edge_t *edges; /** edges */
-} graph_t;
+typedef struct worker {
+    pthread_t thread; /** The thread, unused for the main thread */
+    graph_t *graph; /** The shared graph */
+    rng_t rng; /** Random number generator owned by this thread */
+    coloring_t fixed[HUBS_MAX]; /** Colorings of the hubs in the work unit of this thread */
+    coloring_t *colorings; /** Colorings of every vertex index, reused for all attempts */
+    search_t search; /** Local search of this thread, only used in local search mode */
+    solution_t solution; /** Space for the current solution */
+    solution_t best; /** Space for the best solution of a batch */
+} worker_t;
 
 #endif
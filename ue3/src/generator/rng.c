@@ -0,0 +1,51 @@
+/**
+ * @file rng.c
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Random number generator module.
+ *
+ * Implements xoshiro256** by Blackman and Vigna, seeded with splitmix64.
+ **/
+
+#include "rng.h"
+
+static uint64_t rotate(uint64_t x, int k);
+
+void rng_seed(rng_t *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        // splitmix64, never yields an all zero state
+        uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        rng->state[i] = z ^ (z >> 31);
+    }
+}
+
+uint64_t rng_next(rng_t *rng) {
+    uint64_t *s = rng->state;
+    uint64_t result = rotate(s[1] * 5, 7) * 9, t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotate(s[3], 45);
+
+    return result;
+}
+
+uint32_t rng_below(rng_t *rng, uint32_t bound) {
+    return (uint32_t) (((rng_next(rng) >> 32) * bound) >> 32);
+}
+
+/**
+ * @brief Rotates x left by k bits
+ * @param x The value to rotate
+ * @param k The amount of bits, 0 < k < 64
+ * @return The rotated value
+ */
+static uint64_t rotate(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
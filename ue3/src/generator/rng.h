@@ -0,0 +1,55 @@
+/**
+ * @file rng.h
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Random number generator header.
+ *
+ * Declares a small xoshiro256** generator. Every thread owns its own state, so no lock is involved.
+ **/
+
+#ifndef UE3_RNG_H
+#define UE3_RNG_H
+
+#include <stdint.h>
+
+/**
+ * @struct Random number generator struct
+ * @brief State of a xoshiro256** generator
+ * @details Typedef as rng_t
+ */
+typedef struct rng {
+    uint64_t state[4]; /** Generator state, must not be all zero */
+} rng_t;
+
+/**
+ * Seeds a generator
+ *
+ * @brief Expands seed into a full state with splitmix64
+ * @details Different seeds give unrelated sequences, so consecutive numbers may be used for threads
+ * @param rng The generator to seed
+ * @param seed The seed
+ */
+void rng_seed(rng_t *rng, uint64_t seed);
+
+/**
+ * Next random number
+ *
+ * @brief Returns 64 uniformly distributed random bits and advances the generator
+ * @param rng The generator
+ * @return The random bits
+ */
+uint64_t rng_next(rng_t *rng);
+
+/**
+ * Random number below a bound
+ *
+ * @brief Returns a random number in [0, bound) without a division
+ * @details Uses the upper 32 bits of rng_next, the bias is negligible for small bounds
+ * @param rng The generator
+ * @param bound The exclusive upper bound
+ * @return The random number
+ */
+uint32_t rng_below(rng_t *rng, uint32_t bound);
+
+#endif //UE3_RNG_H
@@ -0,0 +1,209 @@
+/**
+ * @file search.c
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Local search module.
+ *
+ * Tabu search in the style of TabuCol. For every vertex the amount of neighbours with each color is kept up to
+ * date, so the change of the conflicts by recoloring a vertex is known without looking at its edges.
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include "search.h"
+
+static void restart(search_t *search);
+
+static void recolor(search_t *search, int vertex, unsigned char color);
+
+static void mark(search_t *search, int vertex, bool conflicting);
+
+void search_init(search_t *search, const graph_t *graph, rng_t *rng) {
+    search->graph = graph;
+    search->rng = rng;
+    search->colors = malloc(graph->vertc);
+    search->counts = malloc(sizeof(unsigned int) * 3 * graph->vertc);
+    search->tabu = malloc(sizeof(unsigned long) * 3 * graph->vertc);
+    search->conflicting = malloc(sizeof(int) * graph->vertc);
+    search->positions = malloc(sizeof(size_t) * graph->vertc);
+    search->step = 0;
+
+    if (graph->vertc > 0 && (search->colors == NULL || search->counts == NULL || search->tabu == NULL ||
+                             search->conflicting == NULL || search->positions == NULL)) {
+        error_exit("Cannot allocate memory");
+    }
+
+    // mark only trusts a position if the entry there matches, so any valid position will do
+    memset(search->positions, 0, sizeof(size_t) * graph->vertc);
+
+    restart(search);
+}
+
+bool search_step(search_t *search) {
+    const unsigned int *counts = search->counts;
+    int vertex = -1;
+    unsigned char color = 0;
+    long delta = 0;
+    unsigned int ties = 0;
+
+    // A coloring without conflicting vertices cannot be improved
+    if (search->conflictingc == 0 || ++search->stale > SEARCH_PATIENCE) {
+        restart(search);
+        return true;
+    }
+
+    for (size_t i = 0; i < search->conflictingc; i++) {
+        int v = search->conflicting[i];
+        unsigned char current = search->colors[v];
+
+        for (unsigned char c = 0; c < 3; c++) {
+            if (c == current) continue;
+
+            long d = (long) counts[3 * v + c] - (long) counts[3 * v + current];
+            bool tabu = search->tabu[3 * v + c] > search->step;
+            bool allowed = !tabu || (long) search->conflicts + d < (long) search->best;
+
+            if (!allowed || (vertex != -1 && d > delta)) continue;
+
+            // Choose uniformly among the moves with the same change
+            if (vertex == -1 || d < delta) {
+                ties = 0;
+            }
+            if (rng_below(search->rng, ++ties) == 0) {
+                vertex = v;
+                color = c;
+                delta = d;
+            }
+        }
+    }
+
+    // Everything is tabu, so take a random move
+    if (vertex == -1) {
+        vertex = search->conflicting[rng_below(search->rng, (uint32_t) search->conflictingc)];
+        color = (unsigned char) ((search->colors[vertex] + 1 + rng_below(search->rng, 2)) % 3);
+    }
+
+    // The old color stays tabu for a while, longer if there are many conflicts
+    search->tabu[3 * vertex + search->colors[vertex]] =
+            search->step + 1 + rng_below(search->rng, 10) + 6 * search->conflictingc / 10;
+    recolor(search, vertex, color);
+    search->step++;
+
+    if (search->conflicts < search->best) {
+        search->best = search->conflicts;
+        search->stale = 0;
+        return true;
+    }
+
+    return false;
+}
+
+void search_solution(const search_t *search, solution_t *solution) {
+    const graph_t *graph = search->graph;
+    size_t pos = 0;
+
+    for (size_t i = 0; i < graph->edgec; i++) {
+        edge_t edge = graph->indexed[i];
+
+        if (search->colors[edge.u] == search->colors[edge.v]) {
+            solution->edges[pos] = graph->edges[i];
+            pos++;
+        }
+    }
+
+    solution->size = pos;
+}
+
+void search_free(search_t *search) {
+    free(search->colors);
+    free(search->counts);
+    free(search->tabu);
+    free(search->conflicting);
+    free(search->positions);
+}
+
+/**
+ * @brief Starts over with a random coloring
+ * @details Counts the colors of all neighbours, which needs time linear in the amount of edges
+ * @param search The search
+ */
+static void restart(search_t *search) {
+    const graph_t *graph = search->graph;
+
+    for (size_t i = 0; i < graph->vertc; i++) {
+        search->colors[i] = (unsigned char) rng_below(search->rng, 3);
+    }
+
+    memset(search->counts, 0, sizeof(unsigned int) * 3 * graph->vertc);
+    memset(search->tabu, 0, sizeof(unsigned long) * 3 * graph->vertc);
+    search->conflictingc = 0;
+
+    size_t twice = 0;
+
+    for (size_t i = 0; i < graph->vertc; i++) {
+        for (size_t j = graph->offsets[i]; j < graph->offsets[i + 1]; j++) {
+            search->counts[3 * i + search->colors[graph->neighbours[j]]]++;
+        }
+
+        unsigned int same = search->counts[3 * i + search->colors[i]];
+
+        twice += same;
+        if (same > 0) mark(search, (int) i, true);
+    }
+
+    // Every edge is seen from both of its vertices
+    search->conflicts = graph->loopc + twice / 2;
+    search->best = search->conflicts;
+    search->stale = 0;
+}
+
+/**
+ * @brief Changes the color of a vertex and updates the counts of its neighbours
+ * @param search The search
+ * @param vertex The vertex index
+ * @param color The new color
+ */
+static void recolor(search_t *search, int vertex, unsigned char color) {
+    const graph_t *graph = search->graph;
+    unsigned char old = search->colors[vertex];
+
+    search->conflicts -= search->counts[3 * vertex + old];
+    search->conflicts += search->counts[3 * vertex + color];
+
+    for (size_t j = graph->offsets[vertex]; j < graph->offsets[vertex + 1]; j++) {
+        int neighbour = graph->neighbours[j];
+        unsigned int *counts = &search->counts[3 * neighbour];
+
+        counts[old]--;
+        counts[color]++;
+
+        if (search->colors[neighbour] == old && counts[old] == 0) mark(search, neighbour, false);
+        if (search->colors[neighbour] == color && counts[color] == 1) mark(search, neighbour, true);
+    }
+
+    search->colors[vertex] = color;
+    mark(search, vertex, search->counts[3 * vertex + color] > 0);
+}
+
+/**
+ * @brief Adds a vertex to or removes it from the conflicting vertices
+ * @details Does nothing if the vertex already is in the right state
+ * @param search The search
+ * @param vertex The vertex index
+ * @param conflicting Whether the vertex has a neighbour of the same color
+ */
+static void mark(search_t *search, int vertex, bool conflicting) {
+    size_t pos = search->positions[vertex];
+    bool present = pos < search->conflictingc && search->conflicting[pos] == vertex;
+
+    if (conflicting && !present) {
+        search->positions[vertex] = search->conflictingc;
+        search->conflicting[search->conflictingc++] = vertex;
+    } else if (!conflicting && present) {
+        // Move the last entry into the gap
+        int last = search->conflicting[--search->conflictingc];
+        search->conflicting[pos] = last;
+        search->positions[last] = pos;
+    }
+}
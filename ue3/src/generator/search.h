@@ -0,0 +1,81 @@
+/**
+ * @file search.h
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Local search header.
+ *
+ * Declares a tabu search over 3-colorings. Instead of drawing new colorings, it recolors single vertices of
+ * a coloring to reduce the amount of edges whose vertices have the same color.
+ **/
+
+#ifndef UE3_SEARCH_H
+#define UE3_SEARCH_H
+
+#include <stdbool.h>
+#include "graph.h"
+#include "rng.h"
+
+#define SEARCH_BATCH (1024) /** Amount of steps between two publishes */
+#define SEARCH_PATIENCE (100000) /** Amount of steps without improvement after which the search restarts */
+
+/**
+ * @struct Search struct
+ * @brief State of a local search
+ * @details Typedef as search_t
+ */
+typedef struct search {
+    const graph_t *graph; /** The graph to color */
+    rng_t *rng; /** Random number generator of the searching thread */
+    unsigned char *colors; /** Color of every vertex index */
+    unsigned int *counts; /** Amount of neighbours with each of the 3 colors for every vertex index */
+    unsigned long *tabu; /** Step until which a vertex must not get each of the 3 colors again */
+    int *conflicting; /** Vertex indices with a neighbour of the same color, in no order */
+    size_t *positions; /** Position of every vertex index in conflicting */
+    size_t conflictingc; /** Amount of entries in conflicting */
+    size_t conflicts; /** Amount of edges whose vertices have the same color */
+    size_t best; /** Fewest conflicts since the last restart */
+    unsigned long step; /** Amount of steps done */
+    unsigned long stale; /** Amount of steps since conflicts was lower than best */
+} search_t;
+
+/**
+ * Starts a search
+ *
+ * @brief Allocates the state and starts with a random coloring
+ * @param search The search to start
+ * @param graph The graph to color, must outlive the search
+ * @param rng Random number generator of the calling thread
+ */
+void search_init(search_t *search, const graph_t *graph, rng_t *rng);
+
+/**
+ * Does a single step
+ *
+ * @brief Recolors the conflicting vertex that reduces the conflicts the most
+ * @details Colors that a vertex had in the last steps are tabu, unless they give a new best coloring.
+ *          Restarts with a random coloring if there was no improvement in SEARCH_PATIENCE steps.
+ *          Needs time linear in the amount of conflicting vertices and the degree of the recolored vertex.
+ * @param search The search
+ * @return True if the coloring has fewer conflicts than any other one since the last restart
+ */
+bool search_step(search_t *search);
+
+/**
+ * Builds a solution
+ *
+ * @brief Collects the edges whose vertices have the same color in the current coloring
+ * @details The solution must have space for the conflicts of the search
+ * @param search The search
+ * @param solution The solution
+ */
+void search_solution(const search_t *search, solution_t *solution);
+
+/**
+ * Frees a search
+ *
+ * @param search The search to free
+ */
+void search_free(search_t *search);
+
+#endif //UE3_SEARCH_H
@@ -0,0 +1,150 @@
+/**
+ * @file transport.c
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Transport module.
+ *
+ * With the shared memory, everything maps to the ring and the fields of the memory. With a socket, every
+ * operation is a request that the supervisor answers, see protocol.h.
+ **/
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "transport.h"
+#include "../common/protocol.h"
+#include "../common/ring.h"
+
+static bool request(transport_t *transport, const message_t *message, const edge_t *edges, uint64_t *answer);
+
+void transport_open(transport_t *transport, const char *instance, const char *path) {
+    transport->buffer = NULL;
+    transport->connected = false;
+    atomic_init(&transport->quit, false);
+
+    if (path == NULL) {
+        transport->buffer = memory_open(instance);
+        transport->max_edges = transport->buffer->max_edges;
+        transport->seed = transport->buffer->seed;
+        transport->hubs = transport->buffer->hubs;
+        return;
+    }
+
+    struct sockaddr_un address;
+    hello_t hello;
+
+    if (strlen(path) >= sizeof(address.sun_path)) error_exit("Socket path is too long");
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    transport->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (transport->fd == -1) error_exit("Cannot create socket");
+
+    if (connect(transport->fd, (struct sockaddr *) &address, sizeof(address)) == -1) {
+        error_exit("Cannot connect to socket. Has the supervisor been started yet?");
+    }
+
+    transport->connected = true;
+
+    if (!protocol_read(transport->fd, &hello, sizeof(hello))) error_exit("Cannot read hello from supervisor");
+
+    if (pthread_mutex_init(&transport->lock, NULL) != 0) error_exit("Cannot create mutex");
+
+    transport->max_edges = (size_t) hello.max_edges;
+    transport->seed = hello.seed;
+    transport->hubs = hello.hubs > HUBS_MAX ? HUBS_MAX : hello.hubs;
+    atomic_init(&transport->best_size, transport->max_edges + 1);
+}
+
+unsigned int transport_unit(transport_t *transport) {
+    if (transport->buffer != NULL) return atomic_fetch_add(&transport->buffer->next_unit, 1);
+
+    message_t message = {MESSAGE_UNIT, 0};
+    uint64_t answer;
+
+    return request(transport, &message, NULL, &answer) ? (unsigned int) answer : 0;
+}
+
+size_t transport_bound(transport_t *transport) {
+    if (transport->buffer != NULL) {
+        return atomic_load_explicit(&transport->buffer->best_size, memory_order_relaxed);
+    }
+
+    return atomic_load_explicit(&transport->best_size, memory_order_relaxed);
+}
+
+bool transport_push(transport_t *transport, const solution_t *solution) {
+    if (transport->buffer != NULL) return ring_push(transport->buffer, solution);
+
+    message_t message = {MESSAGE_SOLUTION, (uint32_t) solution->size};
+    uint64_t answer;
+
+    if (!request(transport, &message, solution->edges, &answer)) return false;
+
+    atomic_store_explicit(&transport->best_size, (size_t) answer, memory_order_relaxed);
+
+    return true;
+}
+
+bool transport_quit(transport_t *transport) {
+    if (transport->buffer != NULL) return atomic_load(&transport->buffer->quit);
+
+    // The supervisor closes the connection when it shuts down. If another thread holds the lock, it is in a
+    // request and will notice that itself.
+    if (!atomic_load(&transport->quit) && pthread_mutex_trylock(&transport->lock) == 0) {
+        char byte;
+
+        if (recv(transport->fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT) == 0) {
+            atomic_store(&transport->quit, true);
+        }
+
+        pthread_mutex_unlock(&transport->lock);
+    }
+
+    return atomic_load(&transport->quit);
+}
+
+void transport_close(transport_t *transport) {
+    memory_close(transport->buffer);
+
+    if (transport->connected) {
+        close(transport->fd);
+        pthread_mutex_destroy(&transport->lock);
+        transport->connected = false;
+    }
+}
+
+/**
+ * @brief Sends a message to the supervisor and waits for the answer
+ * @details Sets the quit flag if the connection was closed. An interrupted request also closes the connection,
+ *          since the answer could not be told apart from the answer to the next request anymore.
+ * @param transport The transport
+ * @param message The message header
+ * @param edges The edges that follow the header, size many
+ * @param answer The answer will be stored here
+ * @return False if the request failed
+ */
+static bool request(transport_t *transport, const message_t *message, const edge_t *edges, uint64_t *answer) {
+    bool result = false;
+
+    pthread_mutex_lock(&transport->lock);
+
+    if (!atomic_load(&transport->quit)) {
+        result = protocol_write(transport->fd, message, sizeof(*message)) &&
+                 protocol_write(transport->fd, edges, sizeof(edge_t) * message->size) &&
+                 protocol_read(transport->fd, answer, sizeof(*answer));
+
+        if (!result) {
+            shutdown(transport->fd, SHUT_RDWR);
+            atomic_store(&transport->quit, true);
+        }
+    }
+
+    pthread_mutex_unlock(&transport->lock);
+
+    return result;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file transport.h
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Transport header.
+ *
+ * Declares the connection of a generator to its supervisor, either through the shared memory ring or through
+ * a Unix domain socket. All functions may be called by several threads at once.
+ **/
+
+#ifndef UE3_TRANSPORT_H
+#define UE3_TRANSPORT_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "../common/common.h"
+
+/**
+ * @struct Transport struct
+ * @brief Connection to the supervisor
+ * @details Typedef as transport_t
+ */
+typedef struct transport {
+    circular_buffer_t *buffer; /** The shared memory, NULL if connected through a socket */
+    int fd; /** The socket, only valid if connected */
+    bool connected; /** Whether the socket is open */
+    pthread_mutex_t lock; /** Keeps the request and answer of a thread on the socket together */
+    atomic_size_t best_size; /** Best size known from the answers of the supervisor, only used with a socket */
+    atomic_bool quit; /** Whether the socket has been closed, only used with a socket */
+    size_t max_edges; /** Maximal number of edges in a solution */
+    uint64_t seed; /** Random seed of this run */
+    unsigned int hubs; /** Amount of highest degree vertices whose colors are fixed by the work unit */
+} transport_t;
+
+/**
+ * Connects to the supervisor
+ *
+ * @brief Opens the shared memory of the instance or connects to the socket
+ * @details Exits if the supervisor cannot be reached
+ * @param transport The transport to open
+ * @param instance The instance id, NULL for the default one. Only used without socket.
+ * @param path The path of the socket of the supervisor, NULL to use the shared memory
+ */
+void transport_open(transport_t *transport, const char *instance, const char *path);
+
+/**
+ * Claims a work unit
+ *
+ * @brief Returns a number that no other generator thread of this supervisor gets
+ * @param transport The transport
+ * @return The work unit, 0 if the supervisor has shut down
+ */
+unsigned int transport_unit(transport_t *transport);
+
+/**
+ * Best size so far
+ *
+ * @brief Returns the size of the best solution of the supervisor, as far as it is known
+ * @param transport The transport
+ * @return The size
+ */
+size_t transport_bound(transport_t *transport);
+
+/**
+ * Publishes a solution
+ *
+ * @brief Sends a solution to the supervisor
+ * @details Blocks while the ring is full
+ * @param transport The transport
+ * @param solution The solution to publish
+ * @return False if interrupted or the supervisor has shut down
+ */
+bool transport_push(transport_t *transport, const solution_t *solution);
+
+/**
+ * Checks for shutdown
+ *
+ * @param transport The transport
+ * @return True if the supervisor has shut down
+ */
+bool transport_quit(transport_t *transport);
+
+/**
+ * Disconnects from the supervisor
+ *
+ * @param transport The transport to close, may never have been opened if zeroed
+ */
+void transport_close(transport_t *transport);
+
+#endif //UE3_TRANSPORT_H
@@ -9,12 +9,18 @@
  **/
 
 #include <signal.h>
+#include <stdatomic.h>
 #include <memory.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
 #include "main.h"
 #include "../common/common.h"
+#include "../common/ring.h"
+#include "server.h"
 
 static void create_signal_handler(void);
 
@@ -22,51 +28,53 @@ static void handle_signal(int signal);
 
 static void clean_up(void);
 
+static void parse_arguments(int argc, char *argv[]);
+
+static void usage(void);
+
+static char *pgm_name; /** Program name */
+static size_t max_edges = SOLUTION_MAX_EDGES; /** Maximal number of edges in a solution */
+static unsigned int capacity = BUFFER_SIZE; /** Amount of slots of the ring */
+static char *instance = NULL; /** Instance id, NULL for the default one */
+static unsigned int hubs = 0; /** Amount of highest degree vertices whose colors are fixed by the work unit */
+static char *socket_path = NULL; /** Path of the socket for generators, NULL if there is none */
 static circular_buffer_t *buffer; /** Shared memory buffer */
-static semaphores_t *semaphores; /** Semaphores */
-volatile sig_atomic_t quit = 0; /** Quit flag */
+atomic_bool quit = false; /** Quit flag */
 
 int main(int argc, char *argv[]) {
+    // This also handles setting pgm_name
+    parse_arguments(argc, argv);
+
     if (atexit(clean_up) != 0) {
         error_exit("Cannot define cleanup function");
     }
 
     create_signal_handler();
 
-    buffer = memory_create();
-    semaphores = semaphores_create();
+    uint64_t seed = (uint64_t) time(NULL) ^ ((uint64_t) getpid() << 32);
+    buffer = memory_create(instance, max_edges, capacity, seed, hubs);
+    ring_cancel(&quit);
 
-    printf("Supervisor started. Waiting for generator results...\n");
-
-    solution_t best;
-
-    memset(&best, 0, sizeof(solution_t));
-    best.size = SOLUTION_MAX_EDGES + 1;
+    if (socket_path != NULL) {
+        server_start(buffer, socket_path);
+    }
 
-    while (!quit) {
-        // Wait if there are no items in the buffer
-        if (sem_wait(semaphores->used) == -1) {
-            // interrupted by system call?
-            if (errno == EINTR) continue;
-            error_exit("Semaphore wait failed");
-        }
+    printf("Supervisor started. Waiting for generator results...\n");
 
-        if (sem_wait(semaphores->mutex) == -1) {
-            // interrupted by system call?
-            if (errno == EINTR) continue;
-            error_exit("Semaphore wait failed");
-        }
+    solution_t best, solution;
 
-        solution_t solution = buffer->solutions[buffer->readpos & (BUFFER_SIZE - 1)];
-        buffer->readpos++;
+    solution_init(&best, max_edges);
+    solution_init(&solution, max_edges);
+    best.size = max_edges + 1;
 
-        // Increment the count of the number of spaces
-        if (sem_post(semaphores->free) == -1) error_exit("Semaphore post failed");
+    while (!atomic_load(&quit)) {
+        // Wait if there are no items in the buffer, interrupted by a signal otherwise
+        if (!ring_pop(buffer, &solution)) continue;
 
         if (solution.size < best.size) {
             if (solution.size == 0) {
                 printf("The graph is 3-colorable!\n");
-                quit = 1;
+                atomic_store(&quit, true);
             } else {
                 printf("Solution with %d edges: ", (int) solution.size);
                 for (int i = 0; i < solution.size; i++) {
@@ -75,28 +83,92 @@ int main(int argc, char *argv[]) {
                 }
                 printf("\n");
             }
-            best = solution;
-        }
+            solution_copy(&best, &solution);
 
-        // Graph is either 3-colorable or a signal was received
-        if (quit) {
-            // Tell generators to shut down
-            buffer->quit = true;
+            // Generators only publish solutions that beat this one
+            atomic_store_explicit(&buffer->best_size, best.size, memory_order_relaxed);
         }
-
-        if (sem_post(semaphores->mutex) == -1) error_exit("Semaphore post failed");
     }
 
+    // Graph is either 3-colorable or a signal was received, tell generators to shut down
+    ring_shutdown(buffer);
+
+    solution_free(&best);
+    solution_free(&solution);
+
     return EXIT_SUCCESS;
 }
 
+/**
+ * @brief Takes the argument vector and parses the options
+ * @details Sets max_edges, capacity, instance, hubs and socket_path
+ * @param argc The argument count
+ * @param argv The argument vector
+ */
+static void parse_arguments(int argc, char *argv[]) {
+    pgm_name = argv[0];
+
+    char *end;
+    long value;
+    int c;
+    while ((c = getopt(argc, argv, "g:i:m:p:u:")) != -1) {
+        switch (c) {
+            case 'g':
+                value = strtol(optarg, &end, 10);
+                if (*end != '\0' || value < 1 || value > GENERATORS_LIMIT) usage();
+
+                // A power of two, so the slot can be selected with a bitmask
+                capacity = 1;
+                while (capacity < SLOTS_PER_GENERATOR * value) capacity *= 2;
+                break;
+            case 'i':
+                instance = optarg;
+                break;
+            case 'm':
+                value = strtol(optarg, &end, 10);
+                if (*end != '\0' || value < 0 || value > MAX_EDGES_LIMIT) usage();
+                max_edges = (size_t) value;
+                break;
+            case 'p':
+                value = strtol(optarg, &end, 10);
+                if (*end != '\0' || value < 0 || value > HUBS_MAX) usage();
+                hubs = (unsigned int) value;
+                break;
+            case 'u':
+                socket_path = optarg;
+                break;
+            default:
+                usage();
+        }
+    }
+
+    if (optind != argc) usage();
+}
+
+/**
+ * Mandatory usage function.
+ * @brief This function writes helpful usage information about the program to stderr.
+ * @details global variables: pgm_name
+ */
+static void usage(void) {
+    fprintf(stderr, "SYNOPSIS\n\t%s [-g generators] [-i instance] [-m edges] [-p hubs] [-u socket]\n"
+                    "\t-g\tExpected amount of generator threads, sizes the ring. Defaults to %d slots\n"
+                    "\t-i\tInstance id, generators must use the same one. Defaults to $%s\n"
+                    "\t-m\tMaximal number of edges in a solution, defaults to %d\n"
+                    "\t-p\tSplit the search into disjoint parts by fixing the colors of the highest degree vertices\n"
+                    "\t-u\tAlso accept generators on this Unix domain socket\n",
+            pgm_name, BUFFER_SIZE, INSTANCE_ENV, SOLUTION_MAX_EDGES);
+    exit(EXIT_FAILURE);
+}
+
 /**
  * @brief Cleans up existing resources
  * @brief should be called with atexit
  */
 static void clean_up(void) {
+    // Server threads use the memory
+    server_stop();
     memory_destroy(buffer);
-    semaphores_destroy(semaphores);
 }
 
 /**
@@ -106,7 +178,7 @@ static void clean_up(void) {
  * @param signal The signal to handle
  */
 static void handle_signal(int signal) {
-    quit = 1;
+    atomic_store(&quit, true);
 }
 
 /**
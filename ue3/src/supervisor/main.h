@@ -5,4 +5,8 @@
 #ifndef MAIN_H
 #define MAIN_H
 
+#define MAX_EDGES_LIMIT (1 << 20) /** Upper bound for the maximal number of edges in a solution */
+#define GENERATORS_LIMIT (1 << 16) /** Upper bound for the expected amount of generator threads */
+#define SLOTS_PER_GENERATOR (2) /** Ring slots per generator thread, so each can publish without waiting */
+
 #endif //MAIN_H
@@ -0,0 +1,289 @@
+/**
+ * @file server.c
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Socket server module.
+ *
+ * One thread accepts connections and starts a detached thread per generator, which translates its messages
+ * into operations on the ring. The threads must not call error_exit, because server_stop runs at exit and
+ * waits for them.
+ **/
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "server.h"
+#include "../common/protocol.h"
+#include "../common/ring.h"
+
+/**
+ * @struct Connection struct
+ * @brief A connected generator
+ * @details Typedef as connection_t
+ */
+typedef struct connection {
+    int fd; /** The socket */
+    struct connection *next; /** Next connection in the list */
+} connection_t;
+
+static void remove_stale(const struct sockaddr_un *address);
+
+static bool start_thread(void *(*function)(void *), void *arg);
+
+static void *listen_loop(void *arg);
+
+static void *serve(void *arg);
+
+static void thread_end(connection_t *connection);
+
+static circular_buffer_t *buffer; /** The ring of the supervisor */
+static char socket_path[sizeof(((struct sockaddr_un *) NULL)->sun_path)]; /** Path of the socket */
+static int listenfd; /** The listening socket */
+static connection_t *connections = NULL; /** All connected generators */
+static int threads = 0; /** Amount of running threads */
+static bool stopping = false; /** Whether server_stop has been called */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER; /** Protects connections, threads and stopping */
+static pthread_cond_t ended = PTHREAD_COND_INITIALIZER; /** Signaled when a thread ends */
+
+void server_start(circular_buffer_t *shared, const char *path) {
+    struct sockaddr_un address;
+
+    if (strlen(path) >= sizeof(address.sun_path)) error_exit("Socket path is too long");
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    remove_stale(&address);
+
+    listenfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenfd == -1) error_exit("Cannot create socket");
+
+    if (bind(listenfd, (struct sockaddr *) &address, sizeof(address)) == -1) error_exit("Cannot bind socket");
+
+    buffer = shared;
+    strcpy(socket_path, path);
+
+    if (listen(listenfd, SOCKET_BACKLOG) == -1) error_exit("Cannot listen on socket");
+
+    threads = 1;
+    if (!start_thread(listen_loop, NULL)) error_exit("Cannot create thread");
+}
+
+void server_stop(void) {
+    if (buffer == NULL) return;
+
+    // Wakes threads that wait for space in the ring
+    ring_shutdown(buffer);
+
+    pthread_mutex_lock(&lock);
+    stopping = true;
+
+    // Wakes threads that wait in accept or recv
+    shutdown(listenfd, SHUT_RDWR);
+    for (connection_t *connection = connections; connection != NULL; connection = connection->next) {
+        shutdown(connection->fd, SHUT_RDWR);
+    }
+
+    while (threads > 0) {
+        pthread_cond_wait(&ended, &lock);
+    }
+    pthread_mutex_unlock(&lock);
+
+    close(listenfd);
+    unlink(socket_path);
+    buffer = NULL;
+}
+
+/**
+ * @brief Removes the socket of a supervisor that did not shut down cleanly
+ * @details A socket nobody listens on refuses connections. Anything else at the path is left alone, so bind
+ *          fails on it.
+ * @param address The address of the socket
+ */
+static void remove_stale(const struct sockaddr_un *address) {
+    struct stat info;
+
+    if (lstat(address->sun_path, &info) == -1 || !S_ISSOCK(info.st_mode)) return;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) error_exit("Cannot create socket");
+
+    if (connect(fd, (const struct sockaddr *) address, sizeof(*address)) == 0) {
+        error_exit("Socket is in use. Is another supervisor running?");
+    }
+
+    if (errno == ECONNREFUSED && unlink(address->sun_path) == -1) error_exit("Cannot remove stale socket");
+
+    close(fd);
+}
+
+/**
+ * @brief Starts a detached thread that does not receive SIGINT and SIGTERM
+ * @details The signals must reach the main thread, which is the only one to check the quit flag
+ * @param function The function to run
+ * @param arg The argument of the function
+ * @return False if the thread could not be created
+ */
+static bool start_thread(void *(*function)(void *), void *arg) {
+    sigset_t signals, old;
+    pthread_t thread;
+
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+
+    // The new thread inherits the mask
+    pthread_sigmask(SIG_BLOCK, &signals, &old);
+    bool created = pthread_create(&thread, NULL, function, arg) == 0;
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (created) pthread_detach(thread);
+
+    return created;
+}
+
+/**
+ * @brief Accepts generators until the server is stopped
+ * @details Waits ACCEPT_DELAY_NS before accepting again if the process is out of descriptors or memory.
+ *          Stops on any other error, local generators still work then.
+ * @param arg Unused
+ * @return NULL
+ */
+static void *listen_loop(void *arg) {
+    for (;;) {
+        int fd = accept(listenfd, NULL, NULL), error = errno;
+
+        pthread_mutex_lock(&lock);
+
+        if (stopping) {
+            pthread_mutex_unlock(&lock);
+            if (fd != -1) close(fd);
+            break;
+        }
+
+        if (fd == -1) {
+            pthread_mutex_unlock(&lock);
+
+            if (error == EINTR || error == ECONNABORTED) continue;
+
+            if (error == EMFILE || error == ENFILE || error == ENOBUFS || error == ENOMEM) {
+                struct timespec delay = {0, ACCEPT_DELAY_NS};
+                nanosleep(&delay, NULL);
+                continue;
+            }
+
+            fprintf(stderr, "Cannot accept generators anymore: %s\n", strerror(error));
+            break;
+        }
+
+        connection_t *connection = malloc(sizeof(connection_t));
+
+        if (connection != NULL) {
+            connection->fd = fd;
+            connection->next = connections;
+            connections = connection;
+            threads++;
+
+            if (!start_thread(serve, connection)) {
+                // Undo as if the thread had run
+                pthread_mutex_unlock(&lock);
+                thread_end(connection);
+                continue;
+            }
+        } else {
+            close(fd);
+        }
+
+        pthread_mutex_unlock(&lock);
+    }
+
+    thread_end(NULL);
+
+    return NULL;
+}
+
+/**
+ * @brief Serves a single generator
+ * @details Sends the hello and answers messages until the generator disconnects, sends something invalid or
+ *          the ring is shut down
+ * @param arg The connection_t
+ * @return NULL
+ */
+static void *serve(void *arg) {
+    connection_t *connection = arg;
+    int fd = connection->fd;
+    solution_t solution;
+    message_t message;
+    hello_t hello;
+
+    memset(&hello, 0, sizeof(hello));
+    hello.max_edges = buffer->max_edges;
+    hello.seed = buffer->seed;
+    hello.hubs = buffer->hubs;
+
+    solution.size = 0;
+    solution.edges = malloc(sizeof(edge_t) * (buffer->max_edges + 1));
+
+    bool running = solution.edges != NULL && protocol_write(fd, &hello, sizeof(hello));
+
+    while (running && protocol_read(fd, &message, sizeof(message))) {
+        uint64_t answer;
+
+        if (message.type == MESSAGE_UNIT) {
+            answer = atomic_fetch_add(&buffer->next_unit, 1);
+        } else if (message.type == MESSAGE_SOLUTION && message.size <= buffer->max_edges) {
+            solution.size = message.size;
+            if (!protocol_read(fd, solution.edges, sizeof(edge_t) * solution.size)) break;
+
+            // Like local generators, only publish solutions that beat the best one
+            if (solution.size < atomic_load_explicit(&buffer->best_size, memory_order_relaxed)) {
+                if (!ring_push(buffer, &solution)) break;
+            }
+
+            answer = atomic_load_explicit(&buffer->best_size, memory_order_relaxed);
+        } else {
+            break;
+        }
+
+        running = protocol_write(fd, &answer, sizeof(answer));
+    }
+
+    free(solution.edges);
+    thread_end(connection);
+
+    return NULL;
+}
+
+/**
+ * @brief Removes a connection and counts the thread as ended
+ * @param connection The connection to close and free, NULL for the listening thread
+ */
+static void thread_end(connection_t *connection) {
+    pthread_mutex_lock(&lock);
+
+    if (connection != NULL) {
+        for (connection_t **p = &connections; *p != NULL; p = &(*p)->next) {
+            if (*p == connection) {
+                *p = connection->next;
+                break;
+            }
+        }
+
+        close(connection->fd);
+        free(connection);
+    }
+
+    threads--;
+    pthread_cond_signal(&ended);
+    pthread_mutex_unlock(&lock);
+}
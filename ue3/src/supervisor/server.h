@@ -0,0 +1,40 @@
+/**
+ * @file server.h
+ * @author Stefan Geyer <stefan.geyer@student.tuwien.ac.at>
+ * @date 19.10.2026
+ *
+ * @brief Socket server header.
+ *
+ * Lets generators that cannot map the shared memory, for example because they run in another container,
+ * publish their solutions through a Unix domain socket.
+ **/
+
+#ifndef UE3_SERVER_H
+#define UE3_SERVER_H
+
+#include "../common/common.h"
+
+#define SOCKET_BACKLOG (16) /** Amount of pending connections */
+#define ACCEPT_DELAY_NS (100000000L) /** Nanoseconds to wait before accepting again when out of resources */
+
+/**
+ * Starts the server
+ *
+ * @brief Listens on a Unix domain socket and serves every generator in its own thread
+ * @details Solutions of connected generators are pushed into the ring like those of local generators, so the
+ *          supervisor handles them the same way. The threads do not receive SIGINT and SIGTERM.
+ * @param buffer The ring of the supervisor
+ * @param path The path of the socket. A socket left there by a crashed supervisor is removed, anything else
+ *             there is an error
+ */
+void server_start(circular_buffer_t *buffer, const char *path);
+
+/**
+ * Stops the server
+ *
+ * @brief Shuts the ring down, disconnects all generators and waits until all threads of the server have ended
+ * @details Must be called before the shared memory is destroyed and removes the socket
+ */
+void server_stop(void);
+
+#endif //UE3_SERVER_H